@@ -3,6 +3,14 @@
 #include <algorithm>
 #include <fmt/format.h>
 #include <scn/scn.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/spirit/home/x3.hpp>
+#include <boost/spirit/include/qi.hpp>
+
+#include "cache_pressure.hpp"
+#include "pipeline.hpp"
+#include "rng.hpp"
+#include "simd_convert.hpp"
 
 #if __has_include(<charconv>)
 #define HAS_X_CHARS
@@ -13,7 +21,10 @@
 #include <cstring>
 #include <iomanip>
 #include <sstream>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace imp {
 
@@ -31,7 +42,7 @@ double operator()(const char* str, size_t /*len*/) {
 
 struct {
 double operator()(const char* str, size_t /*len*/) {
-  double res;
+  double res = 0;
   std::sscanf(str, "%lf", &res);
   return res;
 }
@@ -40,7 +51,7 @@ double operator()(const char* str, size_t /*len*/) {
 struct {
 double operator()(const char* str, size_t len) {
   std::istringstream in{{str, len}};
-  double res;
+  double res = 0;
   in >> res;
   return res;
 }
@@ -56,22 +67,22 @@ double operator()(const char* str, size_t len) {
     std::use_facet<Facet>(loc).get(from, to, sst, err, d);
   };
 
-  double res;
+  double res = 0;
   read(str, str + len, res);
   return res;
 }
 } num_get;
 
 struct {
-double operator()(const char* str, size_t /*len*/) {
-  return std::stod(str);
+double operator()(const char* str, size_t len) {
+  return std::stod({str, len});
 }
 } stod;
 
 #if __has_include(<charconv>)
 struct {
 double operator()(const char* str, size_t len) {
-  double res;
+  double res = 0;
   std::from_chars(str, str + len, res);
   return res;
 }
@@ -80,12 +91,53 @@ double operator()(const char* str, size_t len) {
 
 struct {
 double operator()(const char* str, size_t len) {
-  double res;
+  double res = 0;
   scn::scan(std::string_view{str, len}, "{}", res);
   return res;
 }
 } scan;
 
+// Without a format string to parse on every call. scnlib 1.x has no
+// compile-time checked format strings; these are its format-free entry points.
+struct {
+double operator()(const char* str, size_t len) {
+  double res = 0;
+  scn::scan_default(std::string_view{str, len}, res);
+  return res;
+}
+} scan_default;
+
+struct {
+double operator()(const char* str, size_t len) {
+  auto result = scn::scan_value<double>(std::string_view{str, len});
+  return result ? result.value() : 0;
+}
+} scan_value;
+
+struct {
+double operator()(const char* str, size_t len) {
+  double res = 0;
+  boost::spirit::qi::parse(str, str + len, parser, res);
+  return res;
+}
+boost::spirit::qi::real_parser<double> parser;
+} qi;
+
+struct {
+double operator()(const char* str, size_t len) {
+  double res = 0;
+  boost::spirit::x3::parse(str, str + len, parser, res);
+  return res;
+}
+boost::spirit::x3::real_parser<double> parser;
+} x3;
+
+struct {
+double operator()(const char* str, size_t len) {
+  return boost::lexical_cast<double>(str, len);
+}
+} lexical_cast;
+
 }
 
 const unsigned kVerifyRandomCount = 100000;
@@ -94,21 +146,6 @@ const unsigned kIterationPerDigit = 10;
 const unsigned kTrial = 10;
 const unsigned kPrecision = 17;
 
-template<typename T>
-class Rng {
-public:
-  explicit Rng(unsigned seed = 0) : gen_{seed} {}
-
-	T operator()() {
-		return dist_(gen_);
-	}
-
-private:
-  std::mt19937 gen_;
-  using dist = std::conditional_t<std::is_integral_v<T>, std::uniform_int_distribution<T>, std::uniform_real_distribution<T>>; 
-  dist dist_;
-};
-
 template<typename F>
 void BenchSequential(benchmark::State& state, F f, const std::string_view name) {
 	char buffer[256] = { '\0' };
@@ -125,7 +162,7 @@ void BenchSequential(benchmark::State& state, F f, const std::string_view name)
 				double d = v * sign;
         const auto [ptr, ec] = std::to_chars(std::begin(buffer), std::end(buffer), d, std::chars_format::fixed, digit);
         *ptr = '\0';
-				benchmark::DoNotOptimize(f(buffer, 256));
+				benchmark::DoNotOptimize(f(buffer, static_cast<size_t>(ptr - buffer)));
 				sign = -sign;
 				v += 1;
 				if (v >= end)
@@ -151,6 +188,310 @@ BENCHMAKR_SEQUENTIAL(stod);
 BENCHMAKR_SEQUENTIAL(from_chars);
 #endif
 BENCHMAKR_SEQUENTIAL(scan);
+BENCHMAKR_SEQUENTIAL(scan_default);
+BENCHMAKR_SEQUENTIAL(scan_value);
+BENCHMAKR_SEQUENTIAL(qi);
+BENCHMAKR_SEQUENTIAL(x3);
+BENCHMAKR_SEQUENTIAL(lexical_cast);
+
+// The SIMD parser through the startup dispatch and pinned to each instruction
+// set; those the CPU lacks are reported as errors.
+BENCHMARK_CAPTURE(BenchSequential, simd, [](const char* str, size_t len) {
+  return simd::dispatch().parse_double(str, len);
+}, "simd")->Name("simd")->Apply(Digits);
+
+template<simd::isa Isa>
+void BenchSequentialSimd(benchmark::State& state) {
+  if (!simd::supported(Isa)) {
+    state.SkipWithError("not supported by this CPU");
+    return;
+  }
+  const auto& c = simd::converters_for(Isa);
+  // Input without digits goes to std::from_chars.
+  for (std::string_view s : {"inf", "-inf", "nan"}) {
+    double expected = 0;
+    std::from_chars(s.data(), s.data() + s.size(), expected);
+    const auto actual = c.parse_double(s.data(), s.size());
+    if (std::isnan(expected) ? !std::isnan(actual) : actual != expected) {
+      throw std::logic_error(fmt::format("{} parsed {} wrong", simd::name(Isa), s));
+    }
+  }
+  BenchSequential(state, [&c](const char* str, size_t len) {
+    return c.parse_double(str, len);
+  }, simd::name(Isa));
+}
+
+#define BENCHMAKR_SEQUENTIAL_SIMD(Isa) BENCHMARK_TEMPLATE(BenchSequentialSimd, simd::isa::Isa)->Name(std::string{"simd/"} + std::string{simd::name(simd::isa::Isa)})->Apply(Digits);
+
+BENCHMAKR_SEQUENTIAL_SIMD(scalar);
+BENCHMAKR_SEQUENTIAL_SIMD(sse42);
+BENCHMAKR_SEQUENTIAL_SIMD(avx2);
+BENCHMAKR_SEQUENTIAL_SIMD(avx512);
+
+// One call at a time on random doubles in their shortest text, after
+// evicting the data caches or the instruction cache, as conversions run when
+// interleaved with other work.
+const std::vector<std::string>& PressureData() {
+  static const auto data = [] {
+    Rng<double> r;
+    std::vector<std::string> data(1000);
+    for (auto& text : data) text = fmt::format("{}", r());
+    return data;
+  }();
+  return data;
+}
+
+template<typename F>
+void BenchPressure(benchmark::State& state, F f, cache_pressure::mode mode) {
+  const auto& data = PressureData();
+  cache_pressure::run(state, mode, [&](size_t i) {
+    const auto& text = data[i % data.size()];
+    return f(text.c_str(), text.size());
+  });
+}
+
+#define BENCHMAKR_PRESSURE(Func)                                                                   \
+  BENCHMARK_CAPTURE(BenchPressure, Func##_dcache, imp::Func, cache_pressure::mode::dcache)         \
+      ->Name(#Func "/dcache")->Apply(cache_pressure::apply);                                       \
+  BENCHMARK_CAPTURE(BenchPressure, Func##_icache, imp::Func, cache_pressure::mode::icache)         \
+      ->Name(#Func "/icache")->Apply(cache_pressure::apply)
+
+BENCHMAKR_PRESSURE(atof);
+BENCHMAKR_PRESSURE(strtod);
+BENCHMAKR_PRESSURE(sscanf);
+BENCHMAKR_PRESSURE(istringstream);
+BENCHMAKR_PRESSURE(num_get);
+BENCHMAKR_PRESSURE(stod);
+#ifdef HAS_X_CHARS
+BENCHMAKR_PRESSURE(from_chars);
+#endif
+BENCHMAKR_PRESSURE(scan);
+BENCHMAKR_PRESSURE(scan_default);
+BENCHMAKR_PRESSURE(scan_value);
+BENCHMAKR_PRESSURE(qi);
+BENCHMAKR_PRESSURE(x3);
+BENCHMAKR_PRESSURE(lexical_cast);
+BENCHMARK_CAPTURE(BenchPressure, simd_dcache, [](const char* str, size_t len) {
+  return simd::dispatch().parse_double(str, len);
+}, cache_pressure::mode::dcache)->Name("simd/dcache")->Apply(cache_pressure::apply);
+BENCHMARK_CAPTURE(BenchPressure, simd_icache, [](const char* str, size_t len) {
+  return simd::dispatch().parse_double(str, len);
+}, cache_pressure::mode::icache)->Name("simd/icache")->Apply(cache_pressure::apply);
+
+namespace imp::f32 {
+
+struct {
+float operator()(const char* str, size_t /*len*/) {
+  return std::strtof(str, nullptr);
+}
+} strtof;
+
+struct {
+float operator()(const char* str, size_t /*len*/) {
+  float res = 0;
+  std::sscanf(str, "%f", &res);
+  return res;
+}
+} sscanf;
+
+struct {
+float operator()(const char* str, size_t len) {
+  return std::stof({str, len});
+}
+} stof;
+
+#ifdef HAS_X_CHARS
+struct {
+float operator()(const char* str, size_t len) {
+  float res = 0;
+  std::from_chars(str, str + len, res);
+  return res;
+}
+} from_chars;
+#endif
+
+struct {
+float operator()(const char* str, size_t len) {
+  auto result = scn::scan_value<float>(std::string_view{str, len});
+  return result ? result.value() : 0;
+}
+} scan_value;
+
+}
+
+// Shortest texts of random normal floats over the whole range; stof throws
+// out_of_range on subnormals.
+class FloatData {
+public:
+  static const size_t kCount = 100'000;
+
+  static const FloatData& Get() {
+    static const FloatData singleton;
+    return singleton;
+  }
+
+  auto begin() const { return mData.begin(); }
+  auto end() const { return mData.end(); }
+
+private:
+  FloatData() {
+    std::mt19937 gen;
+    mData.reserve(kCount);
+    while (mData.size() < kCount) {
+      const uint32_t bits = gen();
+      float f;
+      std::memcpy(&f, &bits, sizeof(f));
+      if (std::isnormal(f)) mData.emplace_back(fmt::format("{}", f), f);
+    }
+  }
+
+  std::vector<std::pair<std::string, float>> mData;
+};
+
+template<typename F>
+void BenchFloat(benchmark::State& state, F f) {
+  const auto& data = FloatData::Get();
+  for (const auto& [str, value] : data) {
+    if (f(str.c_str(), str.size()) != value) throw std::logic_error("wrong float for " + str);
+  }
+
+  for (auto _ : state) {
+    for (const auto& [str, value] : data) {
+      benchmark::DoNotOptimize(f(str.c_str(), str.size()));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * FloatData::kCount);
+}
+
+#define BENCHMAKR_FLOAT(Func) BENCHMARK_CAPTURE(BenchFloat, Func, imp::f32::Func)->Name("float/" #Func);
+
+BENCHMAKR_FLOAT(strtof);
+BENCHMAKR_FLOAT(sscanf);
+BENCHMAKR_FLOAT(stof);
+#ifdef HAS_X_CHARS
+BENCHMAKR_FLOAT(from_chars);
+#endif
+BENCHMAKR_FLOAT(scan_value);
+
+// Random values, with a fraction of them, given in parts per 10000,
+// replaced by malformed, overflowing or empty strings.
+class ErrorData {
+public:
+  static const size_t kCount = 100'000;
+
+  ErrorData(int64_t malformed, int64_t overflow, int64_t empty) {
+    Rng<double> r;
+    std::mt19937 gen;
+    std::uniform_int_distribution<int64_t> dist(0, 9'999);
+
+    mData.reserve(kCount);
+    std::generate_n(std::back_inserter(mData), kCount, [&] {
+      auto value = fmt::format("{}", r());
+      const auto p = dist(gen);
+      if (p < malformed) {
+        value.front() = 'x';
+      } else if (p < malformed + overflow) {
+        value += "e400";
+      } else if (p < malformed + overflow + empty) {
+        value.clear();
+      }
+      return value;
+    });
+  }
+
+  auto begin() const { return mData.begin(); }
+  auto end() const { return mData.end(); }
+
+private:
+  std::vector<std::string> mData;
+};
+
+template<typename F>
+void BenchErrors(benchmark::State& state, F f) {
+  const ErrorData data(state.range(0), state.range(1), state.range(2));
+  int64_t exceptions = 0;
+
+  for (auto _ : state) {
+    for (auto&& value : data) {
+      try {
+        benchmark::DoNotOptimize(f(value.c_str(), value.size()));
+      } catch (const std::exception&) {
+        ++exceptions;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ErrorData::kCount);
+  state.counters["exceptions"] = benchmark::Counter(
+      static_cast<double>(exceptions), benchmark::Counter::kAvgIterations);
+}
+
+void ErrorMix(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"malformed", "overflow", "empty"});
+  b->Args({0, 0, 0});
+  for (int64_t fraction : {100, 1'000}) {
+    b->Args({fraction, 0, 0});
+    b->Args({0, fraction, 0});
+    b->Args({0, 0, fraction});
+  }
+  b->Args({34, 33, 33});
+}
+
+#define BENCHMARK_ERRORS(Func) BENCHMARK_CAPTURE(BenchErrors, Func, imp::Func)->Name(#Func "/errors")->Apply(ErrorMix);
+
+BENCHMARK_ERRORS(atof);
+BENCHMARK_ERRORS(strtod);
+BENCHMARK_ERRORS(sscanf);
+BENCHMARK_ERRORS(istringstream);
+BENCHMARK_ERRORS(num_get);
+BENCHMARK_ERRORS(stod);
+#ifdef HAS_X_CHARS
+BENCHMARK_ERRORS(from_chars);
+#endif
+BENCHMARK_ERRORS(scan);
+BENCHMARK_ERRORS(scan_default);
+BENCHMARK_ERRORS(scan_value);
+BENCHMARK_ERRORS(qi);
+BENCHMARK_ERRORS(x3);
+BENCHMARK_ERRORS(lexical_cast);
+
+// End-to-end pipeline: split a memory-mapped newline-delimited file and parse
+// every token in place. Reports bytes per second of input.
+const corpus& PipelineFile() {
+  static const auto file = pipeline_file("atod-pipeline", 1, 0, [](uint32_t seed) {
+    return [r = Rng<double>{seed}](auto& buffer) mutable { fmt::format_to(std::back_inserter(buffer), "{}", r()); };
+  });
+  return file;
+}
+
+template<typename F>
+void Pipeline(benchmark::State& state, F f) {
+  const auto& file = PipelineFile();
+  for (auto _ : state) {
+    for_each_token(file.payload(), file.payload() + file.payload_size(), '\n', [&](const char* str, size_t len) {
+      benchmark::DoNotOptimize(f(str, len));
+    });
+  }
+  state.SetBytesProcessed(state.iterations() * file.payload_size());
+}
+
+#define BENCHMARK_PIPELINE(Func) BENCHMARK_CAPTURE(Pipeline, Func, imp::Func)->Name(#Func "/pipeline")->Unit(benchmark::kMillisecond);
+
+// Splitting alone, the upper bound for any parser.
+BENCHMARK_CAPTURE(Pipeline, split, [](const char*, size_t len) { return len; })->Name("split/pipeline")->Unit(benchmark::kMillisecond);
+BENCHMARK_PIPELINE(atof);
+BENCHMARK_PIPELINE(strtod);
+// sscanf is left out: glibc's calls strlen on its input, which here is the
+// rest of the file.
+BENCHMARK_PIPELINE(istringstream);
+BENCHMARK_PIPELINE(num_get);
+BENCHMARK_PIPELINE(stod);
+#ifdef HAS_X_CHARS
+BENCHMARK_PIPELINE(from_chars);
+#endif
+BENCHMARK_PIPELINE(scan);
+BENCHMARK_PIPELINE(qi);
+BENCHMARK_PIPELINE(x3);
+BENCHMARK_PIPELINE(lexical_cast);
 
 static void Noop(benchmark::State& state) {
   for (auto _ : state) benchmark::DoNotOptimize(0);
@@ -1,6 +1,14 @@
 #include <benchmark/benchmark.h>
 #include <fmt/format.h>
 #include <scn/scn.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/spirit/home/x3.hpp>
+#include <boost/spirit/include/qi.hpp>
+
+#include "cache_pressure.hpp"
+#include "corpus.hpp"
+#include "pipeline.hpp"
+#include "simd_convert.hpp"
 
 #if __has_include(<charconv>)
 #include <charconv>
@@ -10,46 +18,74 @@
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <string_view>
 #include <random>
 #include <numeric>
+#include <map>
+#if defined(__SSE4_2__) || (defined(_MSC_VER) && defined(__AVX__))
+#include <nmmintrin.h>
+#define HAS_CRC32C
+#endif
 
 // Computes a digest of data. It is used both to prevent compiler from
 // optimizing away the benchmarked code and to verify that the results are
-// correct. The overhead is less than 2.5% compared to just DoNotOptimize.
+// correct. One CRC32C instruction where SSE4.2 is enabled, a multiplicative
+// hash otherwise; either way it is independent of the previous values, so
+// it overlaps with the next conversion. The Digest benchmark below measures
+// its cost alone, to compare with Noop and with the parsers.
 inline unsigned compute_digest(int data) {
-  unsigned digest = 0;
-  data = std::abs(data);
-  do {
-    digest += data % 10;
-  } while (data /= 10);
-  return digest;
+#ifdef HAS_CRC32C
+  return _mm_crc32_u32(0, static_cast<unsigned>(data));
+#else
+  return static_cast<unsigned>((static_cast<uint32_t>(data) * 0x9E3779B97F4A7C15ull) >> 32);
+#endif
 }
 
+// The values are null-terminated strings in a corpus file, generated on the
+// first run and mapped by the later ones. The digest depends on which
+// compute_digest is built, so each has its own file.
 struct Data {
-  std::vector<std::string> values;
+  static constexpr uint32_t kSchema = 1;
+
+  corpus file;
+  std::vector<std::string_view> values;
   unsigned digest;
 
   auto begin() const { return values.begin(); }
   auto end() const { return values.end(); }
 
-  Data() : values(1'000'000) {
+#ifdef HAS_CRC32C
+  Data() : file("atoi-crc32c.corpus", kSchema, std::mt19937::default_seed, generate) {
+#else
+  Data() : file("atoi.corpus", kSchema, std::mt19937::default_seed, generate) {
+#endif
+    values.reserve(file.count());
+    for (const char* p = file.payload(); values.size() < file.count(); p += values.back().size() + 1) {
+      values.emplace_back(p);
+    }
+    digest = static_cast<unsigned>(file.digest());
+  }
+
+  static std::pair<uint64_t, uint64_t> generate(fmt::memory_buffer& payload, uint32_t seed) {
     // Similar data as in Boost Karma int generator test:
     // https://www.boost.org/doc/libs/1_63_0/libs/spirit/workbench/karma/real_generator.cpp
     // with rand replaced by uniform_int_distribution for consistent results
     // across platforms.
-    std::mt19937 gen;
+    const uint64_t count = 1'000'000;
+    std::mt19937 gen(seed);
     std::uniform_int_distribution<int> dist(
         0, RAND_MAX);
-    std::generate(values.begin(), values.end(), [&]() {
+    unsigned digest = 0;
+    for (uint64_t i = 0; i < count; ++i) {
       int scale = dist(gen) / 100 + 1;
-      return fmt::format("{}", static_cast<int>(dist(gen) * dist(gen)) / scale);
-    });
-    digest =
-        std::accumulate(begin(), end(), unsigned(), [](unsigned lhs, const std::string& rhs) {
-          return lhs + compute_digest(std::stoi(rhs));
-        });
+      const int value = static_cast<int>(dist(gen) * dist(gen)) / scale;
+      fmt::format_to(std::back_inserter(payload), "{}", value);
+      payload.push_back('\0');
+      digest += compute_digest(value);
+    }
+    return {count, digest};
   }
 } data;
 
@@ -81,11 +117,14 @@ struct {
 int operator()(const char* str, size_t /*len*/) {
   return static_cast<int>(std::strtol(str, nullptr, 10));
 }
+int operator()(const char* str, size_t /*len*/, int base) {
+  return static_cast<int>(std::strtol(str, nullptr, base));
+}
 } strtol;
 
 struct {
 int operator()(const char* str, size_t /*len*/) {
-  int res;
+  int res = 0;
   std::sscanf(str, "%d", &res);
   return res;
 }
@@ -94,7 +133,7 @@ int operator()(const char* str, size_t /*len*/) {
 struct {
 int operator()(const char* str, size_t len) {
   std::istringstream in{{str, len}};
-  int res;
+  int res = 0;
   in >> res;
   return res;
 }
@@ -110,7 +149,7 @@ int operator()(const char* str, size_t len) {
     std::use_facet<Facet>(loc).get(from, to, sst, err, d);
   };
 
-  long res;
+  long res = 0;
   read(str, str + len, res);
   return static_cast<int>(res);
 }
@@ -125,21 +164,67 @@ int operator()(const char* str, size_t len) {
 #if __has_include(<charconv>)
 struct {
 int operator()(const char* str, size_t len) {
-  int res;
+  int res = 0;
   std::from_chars(str, str + len, res);
   return res;
 }
+int operator()(const char* str, size_t len, int base) {
+  int res = 0;
+  std::from_chars(str, str + len, res, base);
+  return res;
+}
 } from_chars;
 #endif
 
 struct {
 int operator()(const char* str, size_t len) {
-  int res;
+  int res = 0;
   scn::scan(std::string_view{str, len}, "{}", res);
   return res;
 }
 } scan;
 
+// Without a format string to parse on every call. scnlib 1.x has no
+// compile-time checked format strings; these are its format-free entry points.
+struct {
+int operator()(const char* str, size_t len) {
+  int res = 0;
+  scn::scan_default(std::string_view{str, len}, res);
+  return res;
+}
+} scan_default;
+
+struct {
+int operator()(const char* str, size_t len) {
+  auto result = scn::scan_value<int>(std::string_view{str, len});
+  return result ? result.value() : 0;
+}
+} scan_value;
+
+struct {
+int operator()(const char* str, size_t len) {
+  int res = 0;
+  boost::spirit::qi::parse(str, str + len, parser, res);
+  return res;
+}
+boost::spirit::qi::int_parser<int> parser;
+} qi;
+
+struct {
+int operator()(const char* str, size_t len) {
+  int res = 0;
+  boost::spirit::x3::parse(str, str + len, parser, res);
+  return res;
+}
+boost::spirit::x3::int_parser<int> parser;
+} x3;
+
+struct {
+int operator()(const char* str, size_t len) {
+  return boost::lexical_cast<int>(str, len);
+}
+} lexical_cast;
+
 }
 
 template<typename F>
@@ -147,7 +232,7 @@ void FromString(benchmark::State& state, F f) {
   auto dc = DigestChecker(state);
   for (auto s : state) {
     for (auto value : data) {
-      dc.add(f(value.c_str(), value.size()));
+      dc.add(f(value.data(), value.size()));
     }
   }
 }
@@ -164,6 +249,285 @@ BENCHMAKR_ATOI(stoi);
 BENCHMAKR_ATOI(from_chars);
 #endif
 BENCHMAKR_ATOI(scan);
+BENCHMAKR_ATOI(scan_default);
+BENCHMAKR_ATOI(scan_value);
+BENCHMAKR_ATOI(qi);
+BENCHMAKR_ATOI(x3);
+BENCHMAKR_ATOI(lexical_cast);
+
+// One call at a time, after evicting the data caches or the instruction
+// cache, as conversions run when interleaved with other work.
+template<typename F>
+void FromStringPressure(benchmark::State& state, F f, cache_pressure::mode mode) {
+  cache_pressure::run(state, mode, [&](size_t i) {
+    const auto& value = data.values[i % data.values.size()];
+    return f(value.data(), value.size());
+  });
+}
+
+#define BENCHMAKR_ATOI_PRESSURE(Func)                                                              \
+  BENCHMARK_CAPTURE(FromStringPressure, Func##_dcache, imp::Func, cache_pressure::mode::dcache)    \
+      ->Name(#Func "/dcache")->Apply(cache_pressure::apply);                                       \
+  BENCHMARK_CAPTURE(FromStringPressure, Func##_icache, imp::Func, cache_pressure::mode::icache)    \
+      ->Name(#Func "/icache")->Apply(cache_pressure::apply)
+
+BENCHMAKR_ATOI_PRESSURE(atoi);
+BENCHMAKR_ATOI_PRESSURE(strtol);
+BENCHMAKR_ATOI_PRESSURE(sscanf);
+BENCHMAKR_ATOI_PRESSURE(istringstream);
+BENCHMAKR_ATOI_PRESSURE(num_get);
+BENCHMAKR_ATOI_PRESSURE(stoi);
+#if __has_include(<charconv>)
+BENCHMAKR_ATOI_PRESSURE(from_chars);
+#endif
+BENCHMAKR_ATOI_PRESSURE(scan);
+BENCHMAKR_ATOI_PRESSURE(scan_default);
+BENCHMAKR_ATOI_PRESSURE(scan_value);
+BENCHMAKR_ATOI_PRESSURE(qi);
+BENCHMAKR_ATOI_PRESSURE(x3);
+BENCHMAKR_ATOI_PRESSURE(lexical_cast);
+
+// The SIMD parser through the startup dispatch and pinned to each instruction
+// set; those the CPU lacks are reported as errors.
+BENCHMARK_CAPTURE(FromString, simd, [](const char* str, size_t len) {
+  return simd::dispatch().parse_int(str, len);
+})->Name("simd");
+
+template<simd::isa Isa>
+void FromStringSimd(benchmark::State& state) {
+  if (!simd::supported(Isa)) {
+    state.SkipWithError("not supported by this CPU");
+    return;
+  }
+  const auto& c = simd::converters_for(Isa);
+  // Leading zeros are not part of the ten digit limit.
+  for (std::string_view s : {"00000000042", "-000000000007", "-02147483648"}) {
+    int expected = 0;
+    std::from_chars(s.data(), s.data() + s.size(), expected);
+    if (c.parse_int(s.data(), s.size()) != expected) {
+      throw std::logic_error(fmt::format("{} parsed {} wrong", simd::name(Isa), s));
+    }
+  }
+  FromString(state, [&c](const char* str, size_t len) {
+    return c.parse_int(str, len);
+  });
+}
+
+#define BENCHMAKR_ATOI_SIMD(Isa) BENCHMARK_TEMPLATE(FromStringSimd, simd::isa::Isa)->Name(std::string{"simd/"} + std::string{simd::name(simd::isa::Isa)})
+
+BENCHMAKR_ATOI_SIMD(scalar);
+BENCHMAKR_ATOI_SIMD(sse42);
+BENCHMAKR_ATOI_SIMD(avx2);
+BENCHMAKR_ATOI_SIMD(avx512);
+
+// Same values as data, written in base 2, 8 or 16.
+struct BaseData {
+  std::vector<std::string> values;
+
+  auto begin() const { return values.begin(); }
+  auto end() const { return values.end(); }
+
+  explicit BaseData(int base) {
+    values.reserve(data.values.size());
+    for (const auto& value : data) {
+      const int i = std::stoi(std::string{value});
+      switch (base) {
+        case 2: values.push_back(fmt::format("{:b}", i)); break;
+        case 8: values.push_back(fmt::format("{:o}", i)); break;
+        default: values.push_back(fmt::format("{:x}", i)); break;
+      }
+    }
+  }
+
+  static const BaseData& Get(int base) {
+    static std::map<int, BaseData> cache;
+    auto it = cache.find(base);
+    if (it == cache.end()) it = cache.emplace(base, BaseData(base)).first;
+    return it->second;
+  }
+};
+
+template<typename F>
+void FromStringBase(benchmark::State& state, F f) {
+  const auto base = static_cast<int>(state.range(0));
+  const auto& values = BaseData::Get(base);
+  auto dc = DigestChecker(state);
+  for (auto s : state) {
+    for (const auto& value : values) {
+      dc.add(f(value.data(), value.size(), base));
+    }
+  }
+}
+
+void Bases(benchmark::internal::Benchmark* b) {
+  b->ArgName("base");
+  for (int64_t base : {2, 8, 16}) {
+    b->Arg(base);
+  }
+}
+
+#define BENCHMAKR_ATOI_BASE(Func) BENCHMARK_CAPTURE(FromStringBase, Func, imp::Func)->Name(#Func)->Apply(Bases)
+
+BENCHMAKR_ATOI_BASE(strtol);
+#if __has_include(<charconv>)
+BENCHMAKR_ATOI_BASE(from_chars);
+#endif
+
+// The SIMD hexadecimal parser, 16 digits per instruction.
+BENCHMARK_CAPTURE(FromStringBase, simd, [](const char* str, size_t len, int /*base*/) {
+  return simd::dispatch().parse_hex(str, len);
+})->Name("simd")->ArgName("base")->Arg(16);
+
+template<simd::isa Isa>
+void FromStringBaseSimd(benchmark::State& state) {
+  if (!simd::supported(Isa)) {
+    state.SkipWithError("not supported by this CPU");
+    return;
+  }
+  FromStringBase(state, [&c = simd::converters_for(Isa)](const char* str, size_t len, int /*base*/) {
+    return c.parse_hex(str, len);
+  });
+}
+
+#define BENCHMAKR_ATOI_BASE_SIMD(Isa) BENCHMARK_TEMPLATE(FromStringBaseSimd, simd::isa::Isa)->Name(std::string{"simd/"} + std::string{simd::name(simd::isa::Isa)})->ArgName("base")->Arg(16)
+
+BENCHMAKR_ATOI_BASE_SIMD(scalar);
+BENCHMAKR_ATOI_BASE_SIMD(sse42);
+BENCHMAKR_ATOI_BASE_SIMD(avx2);
+BENCHMAKR_ATOI_BASE_SIMD(avx512);
+
+// Same values as data, with a fraction of them, given in parts per 10000,
+// replaced by malformed, overflowing or empty strings.
+struct ErrorData {
+  static const size_t kCount = 100'000;
+
+  std::vector<std::string> values;
+
+  auto begin() const { return values.begin(); }
+  auto end() const { return values.end(); }
+
+  ErrorData(int64_t malformed, int64_t overflow, int64_t empty)
+      : values(data.values.begin(), data.values.begin() + kCount) {
+    std::mt19937 gen;
+    std::uniform_int_distribution<int64_t> dist(0, 9'999);
+    for (auto& value : values) {
+      const auto r = dist(gen);
+      if (r < malformed) {
+        value.front() = 'x';
+      } else if (r < malformed + overflow) {
+        value += "0000000000";
+      } else if (r < malformed + overflow + empty) {
+        value.clear();
+      }
+    }
+  }
+};
+
+template<typename F>
+void FromStringErrors(benchmark::State& state, F f) {
+  const ErrorData errors(state.range(0), state.range(1), state.range(2));
+  int64_t exceptions = 0;
+  for (auto s : state) {
+    for (const auto& value : errors) {
+      try {
+        benchmark::DoNotOptimize(f(value.data(), value.size()));
+      } catch (const std::exception&) {
+        ++exceptions;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * errors.values.size());
+  state.counters["exceptions"] = benchmark::Counter(
+      static_cast<double>(exceptions), benchmark::Counter::kAvgIterations);
+}
+
+void ErrorMix(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"malformed", "overflow", "empty"});
+  b->Args({0, 0, 0});
+  for (int64_t fraction : {100, 1'000}) {
+    b->Args({fraction, 0, 0});
+    b->Args({0, fraction, 0});
+    b->Args({0, 0, fraction});
+  }
+  b->Args({34, 33, 33});
+}
+
+#define BENCHMAKR_ATOI_ERRORS(Func) BENCHMARK_CAPTURE(FromStringErrors, Func, imp::Func)->Name(#Func "/errors")->Apply(ErrorMix)
+
+BENCHMAKR_ATOI_ERRORS(atoi);
+BENCHMAKR_ATOI_ERRORS(strtol);
+BENCHMAKR_ATOI_ERRORS(sscanf);
+BENCHMAKR_ATOI_ERRORS(istringstream);
+BENCHMAKR_ATOI_ERRORS(num_get);
+BENCHMAKR_ATOI_ERRORS(stoi);
+#if __has_include(<charconv>)
+BENCHMAKR_ATOI_ERRORS(from_chars);
+#endif
+BENCHMAKR_ATOI_ERRORS(scan);
+BENCHMAKR_ATOI_ERRORS(scan_default);
+BENCHMAKR_ATOI_ERRORS(scan_value);
+BENCHMAKR_ATOI_ERRORS(qi);
+BENCHMAKR_ATOI_ERRORS(x3);
+BENCHMAKR_ATOI_ERRORS(lexical_cast);
+
+// End-to-end pipeline: split a memory-mapped newline-delimited file and parse
+// every token in place. Reports bytes per second of input.
+const corpus& PipelineFile() {
+  static const auto file = pipeline_file("atoi-pipeline", 1, std::mt19937::default_seed, [](uint32_t seed) {
+    return [gen = std::mt19937{seed}, dist = std::uniform_int_distribution<int>(0, RAND_MAX)](auto& buffer) mutable {
+      int scale = dist(gen) / 100 + 1;
+      fmt::format_to(std::back_inserter(buffer), "{}", static_cast<int>(dist(gen) * dist(gen)) / scale);
+    };
+  });
+  return file;
+}
+
+template<typename F>
+void Pipeline(benchmark::State& state, F f) {
+  const auto& file = PipelineFile();
+  for (auto s : state) {
+    for_each_token(file.payload(), file.payload() + file.payload_size(), '\n', [&](const char* str, size_t len) {
+      benchmark::DoNotOptimize(f(str, len));
+    });
+  }
+  state.SetBytesProcessed(state.iterations() * file.payload_size());
+}
+
+#define BENCHMAKR_ATOI_PIPELINE(Func) BENCHMARK_CAPTURE(Pipeline, Func, imp::Func)->Name(#Func "/pipeline")->Unit(benchmark::kMillisecond)
+
+// Splitting alone, the upper bound for any parser.
+BENCHMARK_CAPTURE(Pipeline, split, [](const char*, size_t len) { return len; })->Name("split/pipeline")->Unit(benchmark::kMillisecond);
+BENCHMAKR_ATOI_PIPELINE(atoi);
+BENCHMAKR_ATOI_PIPELINE(strtol);
+// sscanf is left out: glibc's calls strlen on its input, which here is the
+// rest of the file.
+BENCHMAKR_ATOI_PIPELINE(istringstream);
+BENCHMAKR_ATOI_PIPELINE(num_get);
+BENCHMAKR_ATOI_PIPELINE(stoi);
+#if __has_include(<charconv>)
+BENCHMAKR_ATOI_PIPELINE(from_chars);
+#endif
+BENCHMAKR_ATOI_PIPELINE(scan);
+BENCHMAKR_ATOI_PIPELINE(qi);
+BENCHMAKR_ATOI_PIPELINE(x3);
+BENCHMAKR_ATOI_PIPELINE(lexical_cast);
+
+// The digest alone, over the parsed data, for calibration.
+static void Digest(benchmark::State& state) {
+  static const auto values = [] {
+    std::vector<int> values;
+    values.reserve(data.values.size());
+    for (const auto& value : data) values.push_back(std::stoi(std::string{value}));
+    return values;
+  }();
+  auto dc = DigestChecker(state);
+  for (auto s : state) {
+    for (auto value : values) {
+      dc.add(value);
+    }
+  }
+}
+BENCHMARK(Digest);
 
 static void Noop(benchmark::State& state) {
   for (auto _ : state) benchmark::DoNotOptimize(0);
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "corpus.hpp"
+
+#include <fmt/format.h>
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// The upper half of an IEEE float: 8 exponent bits and 7 mantissa bits.
+struct bfloat16 {
+  uint16_t bits = 0;
+
+  // Rounds to nearest, ties to even, keeping NaNs quiet.
+  static bfloat16 from_float(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    if (std::isnan(f)) return {static_cast<uint16_t>((u >> 16) | 0x40)};
+    return {static_cast<uint16_t>((u + 0x7FFF + ((u >> 16) & 1)) >> 16)};
+  }
+
+  float to_float() const {
+    const uint32_t u = uint32_t{bits} << 16;
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+  }
+};
+
+// The shortest text of every bfloat16 value, so that formatting is a table
+// lookup. A text is shortest when parsing it as a float and rounding to
+// bfloat16 gives the value back; most need 2 to 4 significant digits where
+// to_chars(float) writes up to 9.
+//
+// The table is a corpus, generated on first use and memory-mapped by later
+// runs. Each of the 65536 entries is 16 bytes: the length, then the text.
+class bfloat16_table {
+public:
+  static constexpr size_t kEntrySize = 16;
+  static constexpr size_t kEntries = 1 << 16;
+
+  static const bfloat16_table& get() {
+    static const bfloat16_table table;
+    return table;
+  }
+
+  std::string_view operator[](bfloat16 value) const {
+    const char* entry = file_.payload() + kEntrySize * value.bits;
+    return {entry + 1, static_cast<size_t>(entry[0])};
+  }
+
+  // Writes the text of value to out, which must have room for kEntrySize - 1
+  // characters, and returns its length.
+  size_t format(bfloat16 value, char* out) const {
+    const char* entry = file_.payload() + kEntrySize * value.bits;
+    std::memcpy(out, entry + 1, kEntrySize - 1);
+    return static_cast<size_t>(entry[0]);
+  }
+
+  static std::string shortest(bfloat16 value) {
+    const float f = value.to_float();
+    char buf[32];
+    if (std::isfinite(f)) {
+      for (int precision = 1; precision < 9; ++precision) {
+        const auto end = std::to_chars(buf, buf + sizeof(buf), f, std::chars_format::scientific, precision - 1).ptr;
+        float back = 0;
+        if (std::from_chars(buf, end, back).ec == std::errc{} && bfloat16::from_float(back).bits == value.bits) {
+          // The float nearest to these digits; its own shortest text has no
+          // more of them and picks the shorter of fixed and scientific.
+          return {buf, std::to_chars(buf, buf + sizeof(buf), back).ptr};
+        }
+      }
+    }
+    return {buf, std::to_chars(buf, buf + sizeof(buf), f).ptr};
+  }
+
+private:
+  static constexpr uint32_t kSchema = 1;
+
+  bfloat16_table() : file_("bfloat16.corpus", kSchema, 0, generate) {}
+
+  static std::pair<uint64_t, uint64_t> generate(fmt::memory_buffer& payload, uint32_t) {
+    for (size_t bits = 0; bits < kEntries; ++bits) {
+      const auto text = shortest({static_cast<uint16_t>(bits)});
+      char entry[kEntrySize] = {static_cast<char>(text.size())};
+      text.copy(entry + 1, kEntrySize - 1);
+      payload.append(entry, entry + kEntrySize);
+    }
+    return {kEntries, 0};
+  }
+
+  corpus file_;
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "simd_convert.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Integers of any length parsed from and formatted to decimal strings. The
+// magnitude is kept in base 10^19 limbs, least significant first, so that
+// converting from and to decimal needs no division of the whole number.
+//
+// Parsing reads 8 digits at a time with SWAR arithmetic, formatting writes
+// 2 digits at a time from a table, and addition resolves the carries of 64
+// limbs with one integer addition of the generate and propagate masks.
+namespace decimal {
+
+namespace detail {
+
+constexpr uint64_t kLimbBase = 10000000000000000000ull;
+constexpr size_t kLimbDigits = 19;
+
+inline bool all_digits8(uint64_t v) {
+  return (((v + 0x4646464646464646ull) | (v - 0x3030303030303030ull)) & 0x8080808080808080ull) == 0;
+}
+
+// 8 digits, most significant first in memory, to their value.
+inline uint32_t parse8(const char* str, bool& valid) {
+  uint64_t v;
+  std::memcpy(&v, str, 8);
+  valid &= all_digits8(v);
+  v -= 0x3030303030303030ull;
+  v = (v * 10 + (v >> 8)) & 0x00FF00FF00FF00FFull;
+  v = (v * 100 + (v >> 16)) & 0x0000FFFF0000FFFFull;
+  v = (v * 10000 + (v >> 32)) & 0x00000000FFFFFFFFull;
+  return static_cast<uint32_t>(v);
+}
+
+inline uint64_t parse_short(const char* str, size_t len, bool& valid) {
+  uint64_t v = 0;
+  for (size_t i = 0; i < len; ++i) {
+    const unsigned d = static_cast<unsigned char>(str[i]) - '0';
+    valid &= d <= 9;
+    v = v * 10 + d;
+  }
+  return v;
+}
+
+// A full limb of 19 digits.
+inline uint64_t parse_limb(const char* str, bool& valid) {
+  const uint64_t hi = parse8(str, valid);
+  const uint64_t mid = parse8(str + 8, valid);
+  return (hi * 100000000 + mid) * 1000 + parse_short(str + 16, 3, valid);
+}
+
+inline void write8(uint32_t v, char* out) {
+  const uint32_t hi = v / 10000, lo = v % 10000;
+  std::memcpy(out, simd::detail::digit_pairs + 2 * (hi / 100), 2);
+  std::memcpy(out + 2, simd::detail::digit_pairs + 2 * (hi % 100), 2);
+  std::memcpy(out + 4, simd::detail::digit_pairs + 2 * (lo / 100), 2);
+  std::memcpy(out + 6, simd::detail::digit_pairs + 2 * (lo % 100), 2);
+}
+
+// A full limb, zero padded to 19 digits.
+inline void write_limb(uint64_t v, char* out) {
+  const auto hi = static_cast<uint32_t>(v / 10000000000000000ull);
+  const auto lo = v % 10000000000000000ull;
+  out[0] = static_cast<char>('0' + hi / 100);
+  std::memcpy(out + 1, simd::detail::digit_pairs + 2 * (hi % 100), 2);
+  write8(static_cast<uint32_t>(lo / 100000000), out + 3);
+  write8(static_cast<uint32_t>(lo % 100000000), out + 11);
+}
+
+// Adds (or subtracts, the larger magnitude being a) b to a, limb by limb.
+// Limbs are in [0, 10^19), so sums are computed modulo 2^64 and carries are
+// found by comparison instead of from the sum.
+inline void add_limbs(std::vector<uint64_t>& a, const std::vector<uint64_t>& b, bool subtract) {
+  constexpr size_t kBlock = 64;
+  if (!subtract) a.resize(std::max(a.size(), b.size()) + 1);
+  const size_t n = a.size();
+  bool carry = false;
+  for (size_t block = 0; block < n; block += kBlock) {
+    const size_t size = std::min(kBlock, n - block);
+    uint64_t* x = a.data() + block;
+    const uint64_t* y = b.data() + block;
+    const size_t common = b.size() > block ? std::min(size, b.size() - block) : 0;
+
+    uint64_t generate = 0, propagate = 0;
+    for (size_t i = 0; i < size; ++i) {
+      const uint64_t r = i < common ? y[i] : 0;
+      const bool g = subtract ? x[i] < r : x[i] >= kLimbBase - r;
+      const bool p = subtract ? x[i] == r : x[i] == kLimbBase - 1 - r;
+      generate |= uint64_t{g} << i;
+      propagate |= uint64_t{p} << i;
+    }
+    const uint64_t s1 = generate + (generate | propagate);
+    const uint64_t s2 = s1 + carry;
+    carry = s1 < generate || s2 < s1;
+    const uint64_t in = s2 ^ propagate;
+    const uint64_t out = generate | (propagate & in);
+
+    for (size_t i = 0; i < size; ++i) {
+      const uint64_t r = i < common ? y[i] : 0;
+      const uint64_t c = (in >> i) & 1;
+      const uint64_t wrap = ((out >> i) & 1) * kLimbBase;
+      x[i] = subtract ? x[i] - r - c + wrap : x[i] + r + c - wrap;
+    }
+  }
+  while (a.size() > 1 && a.back() == 0) a.pop_back();
+}
+
+}
+
+class big_integer {
+public:
+  big_integer() : limbs_(1, 0) {}
+
+  // Parses [+-]digits, throwing std::invalid_argument on anything else.
+  explicit big_integer(std::string_view str) {
+    const auto original = str;
+    if (!str.empty() && (str.front() == '-' || str.front() == '+')) {
+      negative_ = str.front() == '-';
+      str.remove_prefix(1);
+    }
+    bool valid = !str.empty();
+    limbs_.reserve(str.size() / detail::kLimbDigits + 1);
+    auto end = str.data() + str.size();
+    for (; end - str.data() >= static_cast<ptrdiff_t>(detail::kLimbDigits); end -= detail::kLimbDigits) {
+      limbs_.push_back(detail::parse_limb(end - detail::kLimbDigits, valid));
+    }
+    if (end != str.data()) {
+      limbs_.push_back(detail::parse_short(str.data(), end - str.data(), valid));
+    }
+    if (!valid) {
+      throw std::invalid_argument("cannot parse '" + std::string{original} + "'");
+    }
+    while (limbs_.size() > 1 && limbs_.back() == 0) limbs_.pop_back();
+    if (is_zero()) negative_ = false;
+  }
+
+  big_integer& operator+=(const big_integer& rhs) {
+    if (negative_ == rhs.negative_) {
+      detail::add_limbs(limbs_, rhs.limbs_, false);
+    } else if (compare_magnitude(rhs) >= 0) {
+      detail::add_limbs(limbs_, rhs.limbs_, true);
+    } else {
+      auto limbs = rhs.limbs_;
+      detail::add_limbs(limbs, limbs_, true);
+      limbs_ = std::move(limbs);
+      negative_ = rhs.negative_;
+    }
+    if (is_zero()) negative_ = false;
+    return *this;
+  }
+
+  friend big_integer operator+(big_integer lhs, const big_integer& rhs) { return lhs += rhs; }
+
+  // An upper bound on the characters written by format.
+  size_t max_size() const { return 1 + limbs_.size() * detail::kLimbDigits; }
+
+  char* format(char* out) const {
+    if (negative_) *out++ = '-';
+    char top[detail::kLimbDigits];
+    detail::write_limb(limbs_.back(), top);
+    const auto first = std::find_if(top, top + detail::kLimbDigits - 1, [](char c) { return c != '0'; });
+    out = std::copy(first, top + detail::kLimbDigits, out);
+    for (auto it = limbs_.rbegin() + 1; it != limbs_.rend(); ++it) {
+      detail::write_limb(*it, out);
+      out += detail::kLimbDigits;
+    }
+    return out;
+  }
+
+  std::string to_string() const {
+    std::string res(max_size(), '\0');
+    res.resize(format(res.data()) - res.data());
+    return res;
+  }
+
+private:
+  bool is_zero() const { return limbs_.size() == 1 && limbs_[0] == 0; }
+
+  int compare_magnitude(const big_integer& rhs) const {
+    if (limbs_.size() != rhs.limbs_.size()) return limbs_.size() < rhs.limbs_.size() ? -1 : 1;
+    for (size_t i = limbs_.size(); i-- != 0;) {
+      if (limbs_[i] != rhs.limbs_[i]) return limbs_[i] < rhs.limbs_[i] ? -1 : 1;
+    }
+    return 0;
+  }
+
+  bool negative_ = false;
+  std::vector<uint64_t> limbs_;
+};
+
+}
@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "big_integer.hpp"
+#include "decimal_add.hpp"
+
+// String add(String lhs, String rhs) for integers longer than 64 bits.
+
+namespace imp {
+
+struct {
+  std::string operator()(std::string_view lhs, std::string_view rhs) const {
+    return (decimal::big_integer(lhs) + decimal::big_integer(rhs)).to_string();
+  }
+} big_integer;
+
+struct {
+  std::string operator()(std::string_view lhs, std::string_view rhs) const {
+    return decimal::add(lhs, rhs);
+  }
+} decimal_add;
+
+struct {
+  std::string operator()(std::string_view lhs, std::string_view rhs) const {
+    using boost::multiprecision::cpp_int;
+    return (cpp_int(std::string{lhs}) + cpp_int(std::string{rhs})).str();
+  }
+} cpp_int;
+
+}
+
+// Random signed integers with the given number of digits.
+const auto& Numbers(size_t digits) {
+  static std::map<size_t, std::vector<std::string>> cache;
+  auto it = cache.find(digits);
+  if (it == cache.end()) {
+    std::mt19937 gen;
+    std::uniform_int_distribution<int> first('1', '9'), digit('0', '9');
+    std::vector<std::string> numbers(2 * std::max<size_t>(100000 / digits, 10));
+    for (auto& number : numbers) {
+      if (gen() % 2) number += '-';
+      number += static_cast<char>(first(gen));
+      for (size_t i = 1; i < digits; ++i) {
+        number += static_cast<char>(digit(gen));
+      }
+    }
+    it = cache.emplace(digits, std::move(numbers)).first;
+  }
+  return it->second;
+}
+
+template<typename F>
+void Add(benchmark::State& state, F f) {
+  const auto& numbers = Numbers(state.range(0));
+  for (size_t i = 0; i < numbers.size(); i += 2) {
+    if (f(numbers[i], numbers[i + 1]) != decimal::add(numbers[i], numbers[i + 1])) {
+      throw std::logic_error("wrong sum of " + numbers[i] + " and " + numbers[i + 1]);
+    }
+  }
+  for (auto _ : state) {
+    for (size_t i = 0; i < numbers.size(); i += 2) {
+      benchmark::DoNotOptimize(f(numbers[i], numbers[i + 1]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * numbers.size() / 2);
+  state.SetBytesProcessed(state.iterations() * numbers.size() * state.range(0));
+}
+
+// Accumulates all the numbers and formats the total once.
+template<typename T>
+std::string Sum(const std::vector<std::string>& numbers) {
+  T total;
+  for (const auto& number : numbers) {
+    total += T(number);
+  }
+  if constexpr (std::is_same_v<T, decimal::big_integer>) {
+    return total.to_string();
+  } else {
+    return total.str();
+  }
+}
+
+template<typename T>
+void Accumulate(benchmark::State& state) {
+  const auto& numbers = Numbers(state.range(0));
+  if (Sum<T>(numbers) != Sum<boost::multiprecision::cpp_int>(numbers)) {
+    throw std::logic_error("wrong sum");
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Sum<T>(numbers));
+  }
+  state.SetItemsProcessed(state.iterations() * numbers.size());
+  state.SetBytesProcessed(state.iterations() * numbers.size() * state.range(0));
+}
+
+void Digits(benchmark::internal::Benchmark* b) {
+  b->ArgName("digits");
+  for (int64_t digits : {20, 40, 100, 1000, 10000}) {
+    b->Arg(digits);
+  }
+}
+
+#define BENCHMARK_ADD(Func) BENCHMARK_CAPTURE(Add, Func, imp::Func)->Name("add/" #Func)->Apply(Digits)
+
+BENCHMARK_ADD(big_integer);
+BENCHMARK_ADD(decimal_add);
+BENCHMARK_ADD(cpp_int);
+
+BENCHMARK_TEMPLATE(Accumulate, decimal::big_integer)->Name("sum/big_integer")->Apply(Digits);
+BENCHMARK_TEMPLATE(Accumulate, boost::multiprecision::cpp_int)->Name("sum/cpp_int")->Apply(Digits);
+
+BENCHMARK_MAIN();
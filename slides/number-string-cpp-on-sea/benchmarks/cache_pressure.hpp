@@ -0,0 +1,116 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#define PRESSURE_NOINLINE __declspec(noinline)
+#else
+#define PRESSURE_NOINLINE __attribute__((noinline))
+#endif
+
+// Runs a conversion after other work has pushed its code and tables out of
+// cache, the way it runs in a service that does more than convert numbers.
+// Each benchmark iteration is one call, timed alone with a steady clock; the
+// clock's own overhead is measured once and subtracted.
+namespace cache_pressure {
+
+enum class mode {
+  // L1 and L2 data caches are evicted by reading a buffer at least twice
+  // their size.
+  dcache,
+  // Some 2048 distinct functions are called through pointers, evicting the
+  // instruction cache and branch target buffer.
+  icache,
+};
+
+namespace detail {
+
+inline std::vector<char>& eviction_buffer() {
+  static std::vector<char> buffer = [] {
+    size_t size = 0;
+    for (const auto& cache : benchmark::CPUInfo::Get().caches) {
+      if (cache.level <= 2 && cache.type != "Instruction") size += cache.size;
+    }
+    return std::vector<char>(std::max<size_t>(2 * size, 8 << 20), 1);
+  }();
+  return buffer;
+}
+
+inline void evict_data() {
+  auto& buffer = eviction_buffer();
+  unsigned sum = 0;
+  for (size_t i = 0; i < buffer.size(); i += 64) sum += buffer[i];
+  benchmark::DoNotOptimize(sum);
+}
+
+template<unsigned I>
+PRESSURE_NOINLINE unsigned thrash_step(unsigned x) {
+  for (unsigned k = 0; k < I % 5 + 2; ++k) {
+    x = x * (2 * I + 1) + (x >> (I % 13 + 1)) + I;
+  }
+  return x;
+}
+
+template<unsigned... I>
+constexpr auto thrash_steps(std::integer_sequence<unsigned, I...>) {
+  return std::array<unsigned (*)(unsigned), sizeof...(I)>{&thrash_step<I>...};
+}
+
+inline void evict_instructions() {
+  static constexpr auto steps = thrash_steps(std::make_integer_sequence<unsigned, 2048>{});
+  unsigned x = 1;
+  for (auto step : steps) x = step(x);
+  benchmark::DoNotOptimize(x);
+}
+
+inline std::chrono::duration<double> clock_overhead() {
+  static const auto overhead = [] {
+    auto best = std::chrono::steady_clock::duration::max();
+    for (int i = 0; i < 10'000; ++i) {
+      const auto start = std::chrono::steady_clock::now();
+      best = std::min(best, std::chrono::steady_clock::now() - start);
+    }
+    return std::chrono::duration<double>(best);
+  }();
+  return overhead;
+}
+
+}
+
+inline const char* name(mode m) { return m == mode::dcache ? "dcache" : "icache"; }
+
+// Calls f(i) for the i-th iteration of state after the pressure of mode.
+// The benchmark must be registered with UseManualTime.
+template<typename F>
+void run(benchmark::State& state, mode m, F f) {
+  const auto overhead = detail::clock_overhead();
+  size_t i = 0;
+  for (auto _ : state) {
+    if (m == mode::dcache) {
+      detail::evict_data();
+    } else {
+      detail::evict_instructions();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    benchmark::DoNotOptimize(f(i++));
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    state.SetIterationTime(std::max(elapsed - overhead, std::chrono::duration<double>::zero()).count());
+  }
+}
+
+// Each benchmark runs a fixed number of calls; with manual time the library
+// would otherwise keep evicting until the calls alone add up to its minimum
+// time.
+inline void apply(benchmark::internal::Benchmark* b) {
+  b->UseManualTime()->Iterations(2000)->Unit(benchmark::kNanosecond);
+}
+
+}
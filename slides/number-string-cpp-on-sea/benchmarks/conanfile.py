@@ -6,8 +6,12 @@ class NumberStringBenchmarks(ConanFile):
   requires = [
     'fmt/8.1.1',
     'scnlib/1.1.2',
-    'benchmark/1.6.1'
+    'benchmark/1.6.1',
+    'boost/1.78.0'
   ]
+  default_options = {
+    'boost/*:header_only': True
+  }
   settings = "os", "compiler", "arch", "build_type"
 
   def generate(self):
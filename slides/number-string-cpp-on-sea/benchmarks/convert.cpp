@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <scn/scn.h>
+
+#include <boost/convert.hpp>
+#include <boost/convert/lexical_cast.hpp>
+#include <boost/convert/printf.hpp>
+#include <boost/convert/spirit.hpp>
+#include <boost/convert/stream.hpp>
+#include <boost/convert/strtol.hpp>
+
+#include "../examples/convert_add.hpp"
+#include "decimal_add.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// String add(String lhs, String rhs) through boost::convert, as in
+// examples/all_boost.cpp, with a converter constructed per call or reused,
+// and an exact digit-wise adder that skips the conversion to double.
+
+const int kPrecision = std::numeric_limits<double>::max_digits10 + 1;
+
+// reference point
+struct
+{
+  std::string operator()(std::string_view lhs, std::string_view rhs,
+                         int precision) const
+  {
+    double l, r;
+    std::from_chars(lhs.data(), lhs.data() + lhs.size(), l);
+    std::from_chars(rhs.data(), rhs.data() + rhs.size(), r);
+    std::string res(std::numeric_limits<double>::max_exponent10 + 20, 0);
+    const auto [end, _] =
+        std::to_chars(res.data(), res.data() + res.size(), l + r,
+                      std::chars_format::fixed, precision);
+    res.resize(end - res.data());
+    return res;
+  }
+} X_chars;
+
+struct
+{
+  std::string operator()(std::string_view lhs, std::string_view rhs,
+                         int precision) const
+  {
+    double l, r;
+    scn::scan(lhs, "{}", l);
+    scn::scan(rhs, "{}", r);
+    return fmt::format("{:.{}f}", l + r, precision);
+  }
+} scan_format;
+
+// The inputs already have precision fraction digits, which the exact sum
+// keeps.
+struct
+{
+  std::string operator()(std::string_view lhs, std::string_view rhs,
+                         int /*precision*/) const
+  {
+    return decimal::add(lhs, rhs);
+  }
+} decimal_add;
+
+// Pairs formatted like the lhs/rhs of the example's test, π - 0.2 and 0.2,
+// with random values.
+const auto& Pairs() {
+  static const auto pairs = [] {
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> dist(0, 10);
+    std::vector<std::pair<std::string, std::string>> pairs(1000);
+    for (auto& [lhs, rhs] : pairs) {
+      lhs = fmt::format("{:.{}f}", dist(gen), kPrecision);
+      rhs = fmt::format("{:.{}f}", dist(gen), kPrecision);
+    }
+    return pairs;
+  }();
+  return pairs;
+}
+
+// The sums are checked against X_chars' to within tolerance: each converter
+// rounds them its own way, printf's sum is a float and spirit's default
+// policy keeps 3 fraction digits.
+template<typename F>
+void Add(benchmark::State& state, F f, double tolerance) {
+  const auto& pairs = Pairs();
+  for (const auto& [lhs, rhs] : pairs) {
+    const auto sum = f(lhs, rhs, kPrecision);
+    if (std::abs(std::stod(sum) - std::stod(X_chars(lhs, rhs, kPrecision))) > tolerance) {
+      throw std::logic_error("wrong sum " + sum + " of " + lhs + " and " + rhs);
+    }
+  }
+  for (auto _ : state) {
+    for (const auto& [lhs, rhs] : pairs) {
+      benchmark::DoNotOptimize(f(lhs, rhs, kPrecision));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * pairs.size());
+}
+
+// The sums are below 20.
+const double kDoubleTolerance = 1e-14;
+const double kFloatTolerance = 1e-5;
+
+#define BENCHMARK_CONVERT(Converter, tolerance)                                                    \
+  BENCHMARK_CAPTURE(Add, convert_##Converter, convert<boost::cnv::Converter>, tolerance)           \
+      ->Name("convert<" #Converter ">");                                                           \
+  BENCHMARK_CAPTURE(Add, convert_hoisted_##Converter, convert_hoisted<boost::cnv::Converter>,      \
+                    tolerance)                                                                     \
+      ->Name("convert_hoisted<" #Converter ">")
+
+BENCHMARK_CONVERT(cstream, kDoubleTolerance);
+BENCHMARK_CONVERT(strtol, kDoubleTolerance);
+BENCHMARK_CONVERT(lexical_cast, kDoubleTolerance);
+BENCHMARK_CONVERT(printf, kFloatTolerance);
+BENCHMARK_CONVERT(spirit, 5e-4 + kDoubleTolerance);
+BENCHMARK_CAPTURE(Add, X_chars, X_chars, 0.0)->Name("X_chars");
+BENCHMARK_CAPTURE(Add, scan_format, scan_format, kDoubleTolerance)->Name("scan_format");
+BENCHMARK_CAPTURE(Add, decimal_add, decimal_add, kDoubleTolerance)->Name("decimal_add");
+
+BENCHMARK_MAIN();
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "mapped_file.hpp"
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+// Benchmark inputs generated once and kept in the temporary directory, so
+// that later runs map them instead of generating them again at startup.
+//
+// The file is a header followed by the payload. The header records the
+// schema, a number to bump whenever the generator or the payload layout
+// changes, and the seed; a file written with another schema or seed, or cut
+// short, is generated again.
+class corpus {
+public:
+  struct header {
+    char magic[8];
+    uint32_t schema;
+    uint32_t seed;
+    uint64_t count;
+    uint64_t digest;
+    uint64_t payload_size;
+  };
+
+  // generate(payload, seed) appends the payload, drawn from an engine seeded
+  // with seed, to a fmt::memory_buffer and returns the number of values and
+  // their digest. A generate that takes a third argument, flush, may call
+  // flush() to write out the payload so far and empty the buffer, so that a
+  // large payload need not fit in memory.
+  template<typename Generate>
+  corpus(const std::string& name, uint32_t schema, uint32_t seed, Generate generate) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    if (!open(path, schema, seed)) {
+      // Written aside and renamed, so that a concurrent run never maps a
+      // partial file. The header goes last, once the payload is known.
+      auto temp = path;
+      temp += fmt::format(".{}", std::random_device{}());
+      std::unique_ptr<std::FILE, decltype(&std::fclose)> out{std::fopen(temp.string().c_str(), "wb"), &std::fclose};
+      if (!out) throw std::runtime_error(fmt::format("cannot create {}", temp.string()));
+      const auto write = [&](const void* data, size_t size) {
+        if (std::fwrite(data, 1, size, out.get()) != size)
+          throw std::runtime_error(fmt::format("cannot write {}", temp.string()));
+      };
+      header h{};
+      write(&h, sizeof(h));
+
+      fmt::memory_buffer payload;
+      const auto flush = [&] {
+        write(payload.data(), payload.size());
+        h.payload_size += payload.size();
+        payload.clear();
+      };
+      const auto [count, digest] = [&] {
+        if constexpr (std::is_invocable_v<Generate&, fmt::memory_buffer&, uint32_t, decltype(flush)&>) {
+          return generate(payload, seed, flush);
+        } else {
+          return generate(payload, seed);
+        }
+      }();
+      flush();
+
+      std::memcpy(h.magic, kMagic, sizeof(h.magic));
+      h.schema = schema;
+      h.seed = seed;
+      h.count = count;
+      h.digest = digest;
+      if (std::fseek(out.get(), 0, SEEK_SET) != 0) throw std::runtime_error(fmt::format("cannot write {}", temp.string()));
+      write(&h, sizeof(h));
+      if (std::fclose(out.release()) != 0) throw std::runtime_error(fmt::format("cannot write {}", temp.string()));
+      std::filesystem::rename(temp, path);
+      if (!open(path, schema, seed)) throw std::runtime_error(fmt::format("cannot read {}", path.string()));
+    }
+  }
+
+  uint64_t count() const { return info().count; }
+  uint64_t digest() const { return info().digest; }
+  const char* payload() const { return file_->data() + sizeof(header); }
+  size_t payload_size() const { return info().payload_size; }
+
+private:
+  static constexpr char kMagic[8] = {'N', 'S', 'C', 'O', 'R', 'P', 'U', 'S'};
+  static_assert(sizeof(header) % alignof(uint64_t) == 0, "payload must stay aligned");
+
+  const header& info() const { return *reinterpret_cast<const header*>(file_->data()); }
+
+  bool open(const std::filesystem::path& path, uint32_t schema, uint32_t seed) {
+    std::error_code ec;
+    if (std::filesystem::file_size(path, ec) < sizeof(header) || ec) return false;
+    file_ = std::make_unique<mapped_file>(path);
+    const auto& h = info();
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.schema != schema || h.seed != seed ||
+        file_->size() != sizeof(header) + h.payload_size) {
+      file_.reset();
+      return false;
+    }
+    return true;
+  }
+
+  std::unique_ptr<mapped_file> file_;
+};
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define DECIMAL_SSE2 1
+#include <emmintrin.h>
+#else
+#define DECIMAL_SSE2 0
+#endif
+
+// Exact addition of decimal strings, [+-]digits[.digits], without going
+// through binary floating point. The operands are aligned on the decimal
+// point and added digit-wise; the result keeps the longer fraction.
+//
+// Carries are resolved for 64 digits at a time: a digit sum above 9
+// generates a carry, a sum of exactly 9 propagates one, and adding the
+// generate mask to the generate|propagate mask ripples every carry through
+// in a single integer addition. Digits are stored most significant first,
+// so the masks are bit-reversed around the addition.
+namespace decimal {
+
+namespace detail {
+
+struct operand {
+  bool negative = false;
+  std::string_view integer;
+  std::string_view fraction;
+};
+
+inline operand split(std::string_view str) {
+  operand res;
+  const auto original = str;
+  if (!str.empty() && (str.front() == '-' || str.front() == '+')) {
+    res.negative = str.front() == '-';
+    str.remove_prefix(1);
+  }
+  const auto point = str.find('.');
+  res.integer = str.substr(0, point);
+  if (point != std::string_view::npos) res.fraction = str.substr(point + 1);
+  if (res.integer.empty() && res.fraction.empty()) {
+    throw std::invalid_argument("cannot parse '" + std::string{original} + "'");
+  }
+  return res;
+}
+
+inline uint64_t reverse_bits(uint64_t v) {
+#if defined(_MSC_VER)
+  v = _byteswap_uint64(v);
+#else
+  v = __builtin_bswap64(v);
+#endif
+  v = ((v >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((v & 0x0F0F0F0F0F0F0F0Full) << 4);
+  v = ((v >> 2) & 0x3333333333333333ull) | ((v & 0x3333333333333333ull) << 2);
+  v = ((v >> 1) & 0x5555555555555555ull) | ((v & 0x5555555555555555ull) << 1);
+  return v;
+}
+
+// Carry into each digit of a block given the generate and propagate masks,
+// bit 0 being the most significant digit. carry is the carry into the last
+// digit on entry and the carry out of the first one on exit.
+inline uint64_t carries(uint64_t generate, uint64_t propagate, bool& carry) {
+  const auto g = reverse_bits(generate);
+  const auto p = reverse_bits(propagate);
+  const auto s1 = g + (g | p);
+  const auto s2 = s1 + carry;
+  carry = s1 < g || s2 < s1;
+  return reverse_bits(s2 ^ p);
+}
+
+constexpr size_t kBlock = 64;
+
+// Adds (or subtracts, the larger magnitude being a) the digits of a and b,
+// both of length n, a multiple of kBlock, into a. Returns the final carry.
+inline bool add_digits(uint8_t* a, const uint8_t* b, size_t n, bool subtract) {
+  bool carry = false;
+  for (size_t block = n; block != 0; block -= kBlock) {
+    uint8_t* x = a + block - kBlock;
+    const uint8_t* y = b + block - kBlock;
+#if DECIMAL_SSE2
+    __m128i t[kBlock / 16];
+    uint64_t generate = 0, propagate = 0;
+    for (size_t i = 0; i < kBlock / 16; ++i) {
+      const auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + 16 * i));
+      const auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + 16 * i));
+      uint64_t g, p;
+      if (subtract) {
+        t[i] = _mm_sub_epi8(va, vb);
+        g = static_cast<unsigned>(_mm_movemask_epi8(t[i]));
+        p = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(t[i], _mm_setzero_si128())));
+      } else {
+        t[i] = _mm_add_epi8(va, vb);
+        g = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(t[i], _mm_set1_epi8(9))));
+        p = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(t[i], _mm_set1_epi8(9))));
+      }
+      generate |= g << (16 * i);
+      propagate |= p << (16 * i);
+    }
+    const auto c = carries(generate, propagate, carry);
+    const auto bits = _mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+    for (size_t i = 0; i < kBlock / 16; ++i) {
+      const auto m = static_cast<uint16_t>(c >> (16 * i));
+      const auto spread = _mm_unpacklo_epi64(_mm_set1_epi8(static_cast<char>(m & 0xFF)),
+                                             _mm_set1_epi8(static_cast<char>(m >> 8)));
+      // 0xFF where a carry comes in.
+      const auto in = _mm_cmpeq_epi8(_mm_and_si128(spread, bits), bits);
+      __m128i r;
+      if (subtract) {
+        r = _mm_add_epi8(t[i], in);
+        r = _mm_min_epu8(r, _mm_add_epi8(r, _mm_set1_epi8(10)));
+      } else {
+        r = _mm_sub_epi8(t[i], in);
+        r = _mm_min_epu8(r, _mm_sub_epi8(r, _mm_set1_epi8(10)));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(x + 16 * i), r);
+    }
+#else
+    for (size_t i = kBlock; i-- != 0;) {
+      int d = subtract ? x[i] - y[i] - carry : x[i] + y[i] + carry;
+      carry = subtract ? d < 0 : d > 9;
+      x[i] = static_cast<uint8_t>(subtract ? (d < 0 ? d + 10 : d) : (d > 9 ? d - 10 : d));
+    }
+#endif
+  }
+  return carry;
+}
+
+// Turns the characters of buf into digit values, throwing if any is not a
+// digit.
+inline void to_digits(uint8_t* buf, size_t n, std::string_view original) {
+  bool valid = true;
+#if DECIMAL_SSE2
+  for (size_t i = 0; i < n; i += 16) {
+    auto v = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i)),
+                          _mm_set1_epi8('0'));
+    valid &= _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(9)), v)) == 0xFFFF;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(buf + i), v);
+  }
+#else
+  for (size_t i = 0; i < n; ++i) {
+    buf[i] = static_cast<uint8_t>(buf[i] - '0');
+    valid &= buf[i] <= 9;
+  }
+#endif
+  if (!valid) {
+    throw std::invalid_argument("cannot parse '" + std::string{original} + "'");
+  }
+}
+
+}
+
+// Writes lhs + rhs to out, which must have room for 3 characters more than
+// the longer integer part plus the longer fraction. Returns the end of the
+// written characters.
+inline char* add(std::string_view lhs, std::string_view rhs, char* out) {
+  const auto l = detail::split(lhs);
+  const auto r = detail::split(rhs);
+  const auto integer = std::max(l.integer.size(), r.integer.size());
+  const auto fraction = std::max(l.fraction.size(), r.fraction.size());
+  // One more digit for the carry out of the integer part.
+  const auto digits = std::max<size_t>(integer, 1) + 1 + fraction;
+  const auto n = (digits + detail::kBlock - 1) / detail::kBlock * detail::kBlock;
+
+  uint8_t small[2 * 4 * detail::kBlock];
+  std::vector<uint8_t> large;
+  uint8_t* a = small;
+  if (2 * n > sizeof(small)) {
+    large.resize(2 * n);
+    a = large.data();
+  }
+  uint8_t* b = a + n;
+  std::memset(a, '0', 2 * n);
+  const auto place = [&](uint8_t* buf, const detail::operand& o) {
+    std::memcpy(buf + n - fraction - o.integer.size(), o.integer.data(), o.integer.size());
+    std::memcpy(buf + n - fraction, o.fraction.data(), o.fraction.size());
+  };
+  place(a, l);
+  place(b, r);
+  detail::to_digits(a, n, lhs);
+  detail::to_digits(b, n, rhs);
+
+  const bool subtract = l.negative != r.negative;
+  bool negative = l.negative;
+  if (subtract && std::memcmp(a, b, n) < 0) {
+    std::swap(a, b);
+    negative = r.negative;
+  }
+
+  detail::add_digits(a, b, n, subtract);
+
+  // Leading zeros of the integer part, keeping one digit before the point.
+  size_t first = n - digits;
+  while (first < n - fraction - 1 && a[first] == 0) ++first;
+  const bool zero = std::all_of(a + first, a + n, [](uint8_t d) { return d == 0; });
+  if (negative && !zero) *out++ = '-';
+  for (size_t i = first; i < n; ++i) {
+    if (i == n - fraction) *out++ = '.';
+    *out++ = static_cast<char>('0' + a[i]);
+  }
+  return out;
+}
+
+inline std::string add(std::string_view lhs, std::string_view rhs) {
+  std::string res(lhs.size() + rhs.size() + 3, '\0');
+  res.resize(add(lhs, rhs, res.data()) - res.data());
+  return res;
+}
+
+}
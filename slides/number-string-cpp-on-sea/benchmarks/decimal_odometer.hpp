@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+// The decimal text of an unsigned counter, incremented in place instead of
+// formatted from scratch. An increment touches one digit 9 times out of 10,
+// two digits 9 times out of 100 and so on, so it costs O(1) amortized.
+class decimal_odometer {
+public:
+  explicit decimal_odometer(uint64_t start = 0) {
+    do {
+      buf_[--first_] = static_cast<char>('0' + start % 10);
+      start /= 10;
+    } while (start != 0);
+  }
+
+  decimal_odometer& operator++() {
+    char* digit = buf_ + kSize - 1;
+    while (*digit == '9') {
+      *digit = '0';
+      if (digit == buf_ + first_) {
+        if (first_ == 0) throw std::overflow_error("decimal_odometer overflow");
+        buf_[--first_] = '1';
+        return *this;
+      }
+      --digit;
+    }
+    ++*digit;
+    return *this;
+  }
+
+  const char* data() const { return buf_ + first_; }
+  size_t size() const { return kSize - first_; }
+  std::string_view view() const { return {data(), size()}; }
+
+private:
+  static constexpr size_t kSize = 20;
+
+  char buf_[kSize];
+  size_t first_ = kSize;
+};
@@ -3,6 +3,12 @@
 #include <algorithm>
 #include <fmt/format.h>
 #include <scn/scn.h>
+#include <boost/spirit/include/karma.hpp>
+
+#include "bfloat16.hpp"
+#include "cache_pressure.hpp"
+#include "format_cache.hpp"
+#include "rng.hpp"
 
 #if __has_include(<charconv>)
 #define HAS_X_CHARS
@@ -12,8 +18,15 @@
 #include <cstdlib>
 #include <cstring>
 #include <iomanip>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <vector>
 #include <sstream>
+#include <string>
 #include <string_view>
+#include <utility>
 
 namespace imp {
 
@@ -161,6 +174,37 @@ void operator()(double d, char (&result)[N], int precision) {
 }
 } fmt;
 
+namespace detail {
+
+struct karma_precision_policy : boost::spirit::karma::real_policies<double> {
+  static int floatfield(double) { return fmtflags::fixed; }
+  static bool trailing_zeros(double) { return true; }
+  unsigned precision(double) const { return precision_; }
+  unsigned precision_ = 0;
+};
+
+using karma_generator = boost::spirit::karma::real_generator<double, karma_precision_policy>;
+
+template<size_t... Precision>
+auto karma_generators(std::index_sequence<Precision...>) {
+  return std::array{karma_generator{karma_precision_policy{{}, Precision}}...};
+}
+
+}
+
+// One generator per precision, built once, since karma takes the precision
+// from the generator's policy.
+struct {
+template<size_t N>
+void operator()(double d, char (&result)[N], int precision) {
+  char* end = result;
+  boost::spirit::karma::generate(end, generators[precision], d);
+  *end = '\0';
+}
+std::array<detail::karma_generator, 18> generators =
+    detail::karma_generators(std::make_index_sequence<18>{});
+} karma;
+
 }
 
 const unsigned kVerifyRandomCount = 100000;
@@ -169,21 +213,6 @@ const unsigned kIterationPerDigit = 10;
 const unsigned kTrial = 10;
 const unsigned kPrecision = 17;
 
-template<typename T>
-class Rng {
-public:
-  explicit Rng(unsigned seed = 0) : gen_{seed} {}
-
-	T operator()() {
-		return dist_(gen_);
-	}
-
-private:
-  std::mt19937 gen_;
-  using dist = std::conditional_t<std::is_integral_v<T>, std::uniform_int_distribution<T>, std::uniform_real_distribution<T>>; 
-  dist dist_;
-};
-
 class RandomData {
 public:
 	static auto GetData() {
@@ -242,6 +271,299 @@ BENCHMARK_RANDOM(to_string);
 BENCHMARK_RANDOM(to_chars);
 #endif
 BENCHMARK_RANDOM(fmt);
+BENCHMARK_RANDOM(karma);
+
+// One call at a time at full precision, after evicting the data caches or the
+// instruction cache, as conversions run when interleaved with other work.
+template<typename F>
+void BenchPressure(benchmark::State& state, F f, cache_pressure::mode mode) {
+  char buffer[256];
+  const auto data = RandomData::GetData();
+  cache_pressure::run(state, mode, [&](size_t i) {
+    f(data[i % data.size()], buffer, kPrecision);
+    return buffer[0];
+  });
+}
+
+#define BENCHMARK_PRESSURE(Func)                                                                   \
+  BENCHMARK_CAPTURE(BenchPressure, Func##_dcache, imp::Func, cache_pressure::mode::dcache)         \
+      ->Name(#Func "/dcache")->Apply(cache_pressure::apply);                                       \
+  BENCHMARK_CAPTURE(BenchPressure, Func##_icache, imp::Func, cache_pressure::mode::icache)         \
+      ->Name(#Func "/icache")->Apply(cache_pressure::apply)
+
+BENCHMARK_PRESSURE(dtoa);
+BENCHMARK_PRESSURE(gcvt);
+BENCHMARK_PRESSURE(sprintf);
+BENCHMARK_PRESSURE(ostringstream);
+BENCHMARK_PRESSURE(num_put);
+BENCHMARK_PRESSURE(to_string);
+#ifdef HAS_X_CHARS
+BENCHMARK_PRESSURE(to_chars);
+#endif
+BENCHMARK_PRESSURE(fmt);
+BENCHMARK_PRESSURE(karma);
+
+// Prices on a 0.01 tick grid, drawn from cardinality distinct values.
+const std::vector<double>& TickData(size_t cardinality) {
+  static std::map<size_t, std::vector<double>> cache;
+  auto it = cache.find(cardinality);
+  if (it == cache.end()) {
+    std::mt19937 gen;
+    std::uniform_int_distribution<size_t> dist(1, cardinality);
+    std::vector<double> values(100'000);
+    std::generate(values.begin(), values.end(), [&] { return dist(gen) / 100.0; });
+    it = cache.emplace(cardinality, std::move(values)).first;
+  }
+  return it->second;
+}
+
+const int kTickPrecision = 2;
+
+// Adapts a formatter that null-terminates its result to format_cache.
+template<typename F>
+auto Terminated(F f) {
+  return [f](double d, auto& result) mutable {
+    f(d, result, kTickPrecision);
+    return std::strlen(result);
+  };
+}
+
+template<typename F>
+void BenchCardinality(benchmark::State& state, F f) {
+  char buffer[256];
+  const auto& data = TickData(state.range(0));
+  auto format = Terminated(f);
+
+  for (auto _ : state) {
+    for (auto&& d : data) {
+      benchmark::DoNotOptimize(format(d, buffer));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+
+template<typename F>
+void BenchCached(benchmark::State& state, F f) {
+  const auto& data = TickData(state.range(0));
+  format_cache<double, decltype(Terminated(f))> cache(Terminated(f));
+  char buffer[256];
+  for (auto&& d : data) {
+    if (cache(d) != std::string_view{buffer, Terminated(f)(d, buffer)}) {
+      throw std::logic_error("cached text differs");
+    }
+  }
+
+  for (auto _ : state) {
+    for (auto&& d : data) {
+      benchmark::DoNotOptimize(cache(d).data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+
+void Cardinality(benchmark::internal::Benchmark* b) {
+  b->ArgName("cardinality");
+  for (int64_t cardinality = 1; cardinality <= 100'000; cardinality *= 10) {
+    b->Arg(cardinality);
+  }
+}
+
+#define BENCHMARK_CARDINALITY(Func)                                                                \
+  BENCHMARK_CAPTURE(BenchCardinality, Func, imp::Func)->Name(#Func)->Apply(Cardinality);           \
+  BENCHMARK_CAPTURE(BenchCached, Func, imp::Func)->Name("cached/" #Func)->Apply(Cardinality)
+
+BENCHMARK_CARDINALITY(dtoa);
+BENCHMARK_CARDINALITY(sprintf);
+BENCHMARK_CARDINALITY(karma);
+
+namespace imp::shortest {
+
+// Shortest text that reads back as the same float.
+
+#ifdef HAS_X_CHARS
+struct {
+template<size_t N>
+size_t operator()(float f, char (&result)[N]) {
+  return std::to_chars(std::begin(result), std::end(result), f).ptr - result;
+}
+} to_chars;
+#endif
+
+struct {
+template<size_t N>
+size_t operator()(float f, char (&result)[N]) {
+  return fmt::format_to(result, "{}", f) - result;
+}
+} fmt;
+
+// Not shortest: 9 significant digits always read back as the same float.
+struct {
+template<size_t N>
+size_t operator()(float f, char (&result)[N]) {
+  return std::snprintf(result, N, "%.9g", f);
+}
+} sprintf;
+
+}
+
+// Random normal floats over the whole range, from random bit patterns.
+const std::vector<float>& FloatData() {
+  static const auto data = [] {
+    std::mt19937 gen;
+    std::vector<float> data;
+    data.reserve(RandomData::kCount);
+    while (data.size() < RandomData::kCount) {
+      const uint32_t bits = gen();
+      float f;
+      std::memcpy(&f, &bits, sizeof(f));
+      if (std::isnormal(f)) data.push_back(f);
+    }
+    return data;
+  }();
+  return data;
+}
+
+template<typename F>
+void BenchFloat(benchmark::State& state, F f) {
+  char buffer[256];
+  const auto& data = FloatData();
+  for (auto&& d : data) {
+    float back = 0;
+    std::from_chars(buffer, buffer + f(d, buffer), back);
+    if (back != d) throw std::logic_error("float does not read back");
+  }
+
+  for (auto _ : state) {
+    for (auto&& d : data) {
+      benchmark::DoNotOptimize(f(d, buffer));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+
+#define BENCHMARK_FLOAT(Func) BENCHMARK_CAPTURE(BenchFloat, Func, imp::shortest::Func)->Name("float/" #Func)
+
+#ifdef HAS_X_CHARS
+BENCHMARK_FLOAT(to_chars);
+#endif
+BENCHMARK_FLOAT(fmt);
+BENCHMARK_FLOAT(sprintf);
+
+// The same floats rounded to bfloat16, formatted by to_chars through float or
+// looked up in the table of shortest texts.
+template<typename F>
+void BenchBfloat16(benchmark::State& state, F f) {
+  char buffer[256];
+  std::vector<bfloat16> data;
+  for (auto d : FloatData()) data.push_back(bfloat16::from_float(d));
+  for (auto&& d : data) {
+    float back = 0;
+    std::from_chars(buffer, buffer + f(d, buffer), back);
+    if (bfloat16::from_float(back).bits != d.bits) throw std::logic_error("bfloat16 does not read back");
+  }
+
+  for (auto _ : state) {
+    for (auto&& d : data) {
+      benchmark::DoNotOptimize(f(d, buffer));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+
+#ifdef HAS_X_CHARS
+BENCHMARK_CAPTURE(BenchBfloat16, to_chars, [](bfloat16 d, auto& result) {
+  return imp::shortest::to_chars(d.to_float(), result);
+})->Name("bfloat16/to_chars");
+#endif
+BENCHMARK_CAPTURE(BenchBfloat16, table, [](bfloat16 d, auto& result) {
+  return bfloat16_table::get().format(d, result);
+})->Name("bfloat16/table");
+
+namespace imp::append {
+
+// Appending each value to one growing string, as real output code does.
+
+const size_t kMaxSize = 1 /*'-'*/ + (std::numeric_limits<double>::max_exponent10 + 1) /*integer digits*/ +
+                        1 /*'.'*/ + kPrecision;
+
+#ifdef HAS_X_CHARS
+struct {
+void operator()(std::string& out, double d, int precision) {
+  char buf[kMaxSize];
+  const auto [end, _] = std::to_chars(buf, buf + kMaxSize, d, std::chars_format::fixed, precision);
+  out.append(buf, end);
+}
+} to_chars;
+#endif
+
+struct {
+void operator()(std::string& out, double d, int precision) {
+  fmt::format_to(std::back_inserter(out), "{:.{}f}", d, precision);
+}
+} format_to;
+
+struct {
+void operator()(std::string& out, double d, int precision) {
+  char buf[kMaxSize + 1];
+  out.append(buf, std::snprintf(buf, kMaxSize + 1, "%.*f", precision, d));
+}
+} sprintf;
+
+struct {
+void operator()(std::string& out, double d, int precision) {
+  boost::spirit::karma::generate(std::back_inserter(out), generators[precision], d);
+}
+std::array<detail::karma_generator, 18> generators =
+    detail::karma_generators(std::make_index_sequence<18>{});
+} karma;
+
+}
+
+// How the output string is reserved: not at all, exactly the final size up
+// front, or doubled whenever less than one value's room is left.
+enum class Reserve { none, exact, geometric };
+
+// The string is checked once against the same formatter's text for each
+// value on its own, joined.
+template<typename F>
+void Append(benchmark::State& state, F f, Reserve reserve) {
+  const auto data = RandomData::GetData();
+  std::string expected;
+  for (auto d : data) {
+    std::string text;
+    f(text, d, kPrecision);
+    expected += text;
+  }
+  std::string out;
+  for (auto _ : state) {
+    out = std::string{};
+    if (reserve == Reserve::exact) out.reserve(expected.size());
+    for (auto d : data) {
+      if (reserve == Reserve::geometric && out.capacity() - out.size() < imp::append::kMaxSize + 1)
+        out.reserve(2 * out.capacity() + imp::append::kMaxSize + 1);
+      f(out, d, kPrecision);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  if (out != expected)
+    throw std::logic_error("appended text differs from the values formatted one at a time");
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+
+#define BENCHMARK_APPEND(Func)                                                                     \
+  BENCHMARK_CAPTURE(Append, Func##_none, imp::append::Func, Reserve::none)                         \
+      ->Name("append/" #Func "/none");                                                             \
+  BENCHMARK_CAPTURE(Append, Func##_exact, imp::append::Func, Reserve::exact)                       \
+      ->Name("append/" #Func "/exact");                                                            \
+  BENCHMARK_CAPTURE(Append, Func##_geometric, imp::append::Func, Reserve::geometric)               \
+      ->Name("append/" #Func "/geometric")
+
+#ifdef HAS_X_CHARS
+BENCHMARK_APPEND(to_chars);
+#endif
+BENCHMARK_APPEND(format_to);
+BENCHMARK_APPEND(sprintf);
+BENCHMARK_APPEND(karma);
 
 static void Noop(benchmark::State& state) {
   for (auto _ : state) benchmark::DoNotOptimize(0);
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Wraps a formatter, size_t format(T value, char (&buf)[N]), and remembers
+// the text of the values it has formatted, for columns with few distinct
+// values. The cache is an open-addressing table keyed by the bits of the
+// value: a lookup probes a few slots from the hash of the key and, on a miss,
+// the value is formatted and stored in the first empty slot, or in place of
+// the first one probed when all are taken.
+//
+// The returned view points into the cache and is valid until the next call.
+template<typename T, typename Format, size_t Slots = 4096, size_t Capacity = 23>
+class format_cache {
+  static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(uint64_t));
+  static_assert(Slots > 1 && (Slots & (Slots - 1)) == 0, "Slots must be a power of 2");
+
+public:
+  explicit format_cache(Format format = {}) : format_(std::move(format)), slots_(Slots) {}
+
+  std::string_view operator()(T value) {
+    uint64_t key = 0;
+    std::memcpy(&key, &value, sizeof(T));
+    const size_t home = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - kBits));
+    slot* empty = nullptr;
+    for (size_t i = 0; i < kProbes; ++i) {
+      auto& s = slots_[(home + i) & (Slots - 1)];
+      if (s.length == 0) {
+        empty = &s;
+        break;
+      }
+      if (s.key == key) return {s.text, s.length};
+    }
+
+    const size_t length = format_(value, buffer_);
+    if (length > Capacity) return {buffer_, length};
+    auto& s = empty ? *empty : slots_[home];
+    s.key = key;
+    s.length = static_cast<uint8_t>(length);
+    std::memcpy(s.text, buffer_, length);
+    return {s.text, s.length};
+  }
+
+private:
+  static constexpr size_t kProbes = 4;
+  static constexpr int kBits = [] {
+    int bits = 0;
+    while ((size_t{1} << bits) < Slots) ++bits;
+    return bits;
+  }();
+
+  struct slot {
+    uint64_t key = 0;
+    uint8_t length = 0;
+    char text[Capacity];
+  };
+
+  Format format_;
+  std::vector<slot> slots_;
+  char buffer_[256];
+};
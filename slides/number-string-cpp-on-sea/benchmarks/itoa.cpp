@@ -1,6 +1,14 @@
 #include <benchmark/benchmark.h>
 #include <fmt/format.h>
 #include <scn/scn.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/spirit/include/karma.hpp>
+
+#include "cache_pressure.hpp"
+#include "corpus.hpp"
+#include "decimal_odometer.hpp"
+#include "format_cache.hpp"
+#include "simd_convert.hpp"
 
 #if __has_include(<charconv>)
 #include <charconv>
@@ -10,54 +18,105 @@
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <span>
 #include <sstream>
 #include <string_view>
 #include <random>
 #include <numeric>
+#include <map>
+#if __has_include(<format>)
+#include <format>
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#include <type_traits>
 
 // Computes a digest of data. It is used both to prevent compiler from
 // optimizing away the benchmarked code and to verify that the results are
-// correct. The overhead is less than 2.5% compared to just DoNotOptimize.
+// correct. The bytes are summed 16 at a time with psadbw; the Digest
+// benchmark below measures its cost alone, to compare with Noop and with the
+// formatters.
 inline unsigned compute_digest(std::string_view data) {
+#if defined(__SSE2__) || defined(_M_X64)
+  static constexpr char kMask[32] = {-1, -1, -1, -1, -1, -1, -1, -1,
+                                     -1, -1, -1, -1, -1, -1, -1, -1};
+  const char* p = data.data();
+  size_t n = data.size();
+  const auto zero = _mm_setzero_si128();
+  auto sum = zero;
+  for (; n >= 16; p += 16, n -= 16) {
+    sum = _mm_add_epi64(sum, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), zero));
+  }
+  if (n != 0) {
+    // Loads past the end unless that crosses into the next page, and masks
+    // the extra bytes out.
+    __m128i v;
+    if ((reinterpret_cast<uintptr_t>(p) & 4095) <= 4096 - 16) {
+      v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    } else {
+      char tail[16] = {};
+      std::memcpy(tail, p, n);
+      v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail));
+    }
+    v = _mm_and_si128(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(kMask + 16 - n)));
+    sum = _mm_add_epi64(sum, _mm_sad_epu8(v, zero));
+  }
+  return static_cast<unsigned>(_mm_cvtsi128_si32(_mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum))));
+#else
   unsigned digest = 0;
-  for (char c : data) digest += c;
+  for (char c : data) digest += static_cast<unsigned char>(c);
   return digest;
+#endif
 }
 
+// The values are ints in a corpus file, generated on the first run and
+// mapped by the later ones.
 struct Data {
-  std::vector<int> values;
+  static constexpr uint32_t kSchema = 1;
+
+  corpus file;
+  std::span<const int> values;
   unsigned digest;
 
   auto begin() const { return values.begin(); }
   auto end() const { return values.end(); }
 
-  Data() : values(1'000'000) {
+  Data()
+      : file("itoa.corpus", kSchema, std::mt19937::default_seed, generate),
+        values(reinterpret_cast<const int*>(file.payload()), file.count()),
+        digest(static_cast<unsigned>(file.digest())) {}
+
+  static std::pair<uint64_t, uint64_t> generate(fmt::memory_buffer& payload, uint32_t seed) {
     // Similar data as in Boost Karma int generator test:
     // https://www.boost.org/doc/libs/1_63_0/libs/spirit/workbench/karma/real_generator.cpp
     // with rand replaced by uniform_int_distribution for consistent results
     // across platforms.
-    std::mt19937 gen;
+    const uint64_t count = 1'000'000;
+    std::mt19937 gen(seed);
     std::uniform_int_distribution<int> dist(
         0, RAND_MAX);
-    std::generate(values.begin(), values.end(), [&]() {
+    unsigned digest = 0;
+    for (uint64_t i = 0; i < count; ++i) {
       int scale = dist(gen) / 100 + 1;
-      return static_cast<int>(dist(gen) * dist(gen)) / scale;
-    });
-    digest =
-        std::accumulate(begin(), end(), unsigned(), [](unsigned lhs, int rhs) {
-          return lhs + compute_digest(fmt::format(fmt::runtime("{}"), rhs));
-        });
+      const int value = static_cast<int>(dist(gen) * dist(gen)) / scale;
+      payload.append(reinterpret_cast<const char*>(&value), reinterpret_cast<const char*>(&value + 1));
+      digest += compute_digest(fmt::format_int(value).str());
+    }
+    return {count, digest};
   }
 } data;
 
 struct DigestChecker {
   benchmark::State& state;
+  unsigned expected;
   unsigned digest = 0;
 
-  explicit DigestChecker(benchmark::State& s) : state(s) {}
+  explicit DigestChecker(benchmark::State& s, unsigned e = data.digest) : state(s), expected(e) {}
 
   ~DigestChecker() noexcept(false) {
-    if (digest != static_cast<unsigned>(state.iterations()) * data.digest)
+    if (digest != static_cast<unsigned>(state.iterations()) * expected)
       throw std::logic_error("invalid length");
     state.SetItemsProcessed(state.iterations() * data.values.size());
     benchmark::DoNotOptimize(digest);
@@ -143,23 +202,86 @@ size_t operator()(int d, char(&result)[N]) {
 
 #if __has_include(<charconv>)
 struct {
-template<size_t N>
-size_t operator()(int d, char(&result)[N]) {
+template<typename T, size_t N>
+size_t operator()(T d, char(&result)[N]) {
   const auto [end, _] =
       std::to_chars(std::begin(result), std::end(result), d);
   return end - result;
 }
+template<size_t N>
+size_t operator()(int d, char(&result)[N], int base) {
+  const auto [end, _] =
+      std::to_chars(std::begin(result), std::end(result), d, base);
+  return end - result;
+}
 } to_chars;
 #endif
 
 struct {
-template<size_t N>
-size_t operator()(int d, char(&result)[N]) {
+template<typename T, size_t N>
+size_t operator()(T d, char(&result)[N]) {
   auto end = fmt::format_to(result, "{}", d);
   return end - result;
 }
+template<size_t N>
+size_t operator()(int d, char(&result)[N], int base) {
+  switch (base) {
+    case 2: return fmt::format_to(result, "{:b}", d) - result;
+    case 8: return fmt::format_to(result, "{:o}", d) - result;
+    default: return fmt::format_to(result, "{:x}", d) - result;
+  }
+}
 } format;
 
+struct {
+template<size_t N>
+size_t operator()(int d, char(&result)[N]) {
+  char* end = result;
+  boost::spirit::karma::generate(end, generator, d);
+  return end - result;
+}
+boost::spirit::karma::int_generator<int> generator;
+} karma;
+
+struct {
+template<size_t N>
+size_t operator()(int d, char(&result)[N]) {
+  return boost::lexical_cast<std::string>(d).copy(result, N);
+}
+} lexical_cast;
+
+// Two digits at a time from a table of digit pairs, written backwards.
+struct {
+template<typename T, size_t N>
+size_t operator()(T d, char(&result)[N]) {
+  using U = std::make_unsigned_t<T>;
+  U u = static_cast<U>(d);
+  char* out = result;
+  if constexpr (std::is_signed_v<T>) {
+    if (d < 0) {
+      *out++ = '-';
+      u = U(0) - u;
+    }
+  }
+  char digits[20];
+  char* p = std::end(digits);
+  while (u >= 100) {
+    p -= 2;
+    std::memcpy(p, simd::detail::digit_pairs + 2 * (u % 100), 2);
+    u /= 100;
+  }
+  if (u >= 10) {
+    p -= 2;
+    std::memcpy(p, simd::detail::digit_pairs + 2 * u, 2);
+  } else {
+    *--p = static_cast<char>('0' + u);
+  }
+  const auto size = std::end(digits) - p;
+  std::memcpy(out, p, size);
+  return out + size - result;
+}
+} lut;
+
 }
 
 template<typename F>
@@ -167,8 +289,8 @@ void ToString(benchmark::State& state, F f) {
   auto dc = DigestChecker(state);
   for (auto s : state) {
     for (auto value : data) {
-      const int n = std::numeric_limits<double>::digits10;
-      char buf[n];
+      // Room for a whole 16 byte load by compute_digest.
+      char buf[16];
       auto size = f(value, buf);
       dc.add({buf, size});
     }
@@ -186,6 +308,358 @@ BENCHMARK_RANDOM(to_string);
 BENCHMARK_RANDOM(to_chars);
 #endif
 BENCHMARK_RANDOM(format);
+BENCHMARK_RANDOM(karma);
+BENCHMARK_RANDOM(lexical_cast);
+BENCHMARK_RANDOM(lut);
+
+// One call at a time, after evicting the data caches or the instruction
+// cache, as conversions run when interleaved with other work.
+template<typename F>
+void ToStringPressure(benchmark::State& state, F f, cache_pressure::mode mode) {
+  char buf[16];
+  cache_pressure::run(state, mode, [&](size_t i) {
+    return f(data.values[i % data.values.size()], buf);
+  });
+}
+
+#define BENCHMARK_PRESSURE(Func)                                                                   \
+  BENCHMARK_CAPTURE(ToStringPressure, Func##_dcache, imp::Func, cache_pressure::mode::dcache)      \
+      ->Name(#Func "/dcache")->Apply(cache_pressure::apply);                                       \
+  BENCHMARK_CAPTURE(ToStringPressure, Func##_icache, imp::Func, cache_pressure::mode::icache)      \
+      ->Name(#Func "/icache")->Apply(cache_pressure::apply)
+
+BENCHMARK_PRESSURE(itoa);
+BENCHMARK_PRESSURE(sprintf);
+BENCHMARK_PRESSURE(ostringstream);
+BENCHMARK_PRESSURE(num_put);
+BENCHMARK_PRESSURE(to_string);
+#if __has_include(<charconv>)
+BENCHMARK_PRESSURE(to_chars);
+#endif
+BENCHMARK_PRESSURE(format);
+BENCHMARK_PRESSURE(karma);
+BENCHMARK_PRESSURE(lexical_cast);
+BENCHMARK_PRESSURE(lut);
+
+// The SIMD formatter through the startup dispatch and pinned to each
+// instruction set; those the CPU lacks are reported as errors.
+BENCHMARK_CAPTURE(ToString, simd, [](int d, auto& result) {
+  return simd::dispatch().format_int(d, result);
+})->Name("simd");
+
+template<simd::isa Isa>
+void ToStringSimd(benchmark::State& state) {
+  if (!simd::supported(Isa)) {
+    state.SkipWithError("not supported by this CPU");
+    return;
+  }
+  ToString(state, [&c = simd::converters_for(Isa)](int d, auto& result) {
+    return c.format_int(d, result);
+  });
+}
+
+#define BENCHMARK_SIMD(Isa) BENCHMARK_TEMPLATE(ToStringSimd, simd::isa::Isa)->Name(std::string{"simd/"} + std::string{simd::name(simd::isa::Isa)})
+
+BENCHMARK_SIMD(scalar);
+BENCHMARK_SIMD(sse42);
+BENCHMARK_SIMD(avx2);
+BENCHMARK_SIMD(avx512);
+
+// Digest of data written in base 2, 8 or 16.
+unsigned BaseDigest(int base) {
+  static std::map<int, unsigned> cache;
+  auto it = cache.find(base);
+  if (it == cache.end()) {
+    const auto spec = base == 2 ? "{:b}" : base == 8 ? "{:o}" : "{:x}";
+    it = cache.emplace(base, std::accumulate(data.begin(), data.end(), unsigned(), [&](unsigned lhs, int rhs) {
+      return lhs + compute_digest(fmt::format(fmt::runtime(spec), rhs));
+    })).first;
+  }
+  return it->second;
+}
+
+template<typename F>
+void ToStringBase(benchmark::State& state, F f) {
+  const auto base = static_cast<int>(state.range(0));
+  auto dc = DigestChecker(state, BaseDigest(base));
+  for (auto s : state) {
+    for (auto value : data) {
+      char buf[34];
+      auto size = f(value, buf, base);
+      dc.add({buf, size});
+    }
+  }
+}
+
+void Bases(benchmark::internal::Benchmark* b) {
+  b->ArgName("base");
+  for (int64_t base : {2, 8, 16}) {
+    b->Arg(base);
+  }
+}
+
+#define BENCHMARK_BASE(Func) BENCHMARK_CAPTURE(ToStringBase, Func, imp::Func)->Name(#Func)->Apply(Bases)
+
+#if __has_include(<charconv>)
+BENCHMARK_BASE(to_chars);
+#endif
+BENCHMARK_BASE(format);
+
+// The SIMD hexadecimal formatter, 16 digits per instruction.
+BENCHMARK_CAPTURE(ToStringBase, simd, [](int d, auto& result, int /*base*/) {
+  return simd::dispatch().format_hex(d, result);
+})->Name("simd")->ArgName("base")->Arg(16);
+
+template<simd::isa Isa>
+void ToStringBaseSimd(benchmark::State& state) {
+  if (!simd::supported(Isa)) {
+    state.SkipWithError("not supported by this CPU");
+    return;
+  }
+  ToStringBase(state, [&c = simd::converters_for(Isa)](int d, auto& result, int /*base*/) {
+    return c.format_hex(d, result);
+  });
+}
+
+#define BENCHMARK_BASE_SIMD(Isa) BENCHMARK_TEMPLATE(ToStringBaseSimd, simd::isa::Isa)->Name(std::string{"simd/"} + std::string{simd::name(simd::isa::Isa)})->ArgName("base")->Arg(16)
+
+BENCHMARK_BASE_SIMD(scalar);
+BENCHMARK_BASE_SIMD(sse42);
+BENCHMARK_BASE_SIMD(avx2);
+BENCHMARK_BASE_SIMD(avx512);
+
+// As many values as data, drawn from its first cardinality values.
+struct CardinalityData {
+  std::vector<int> values;
+  unsigned digest = 0;
+
+  auto begin() const { return values.begin(); }
+  auto end() const { return values.end(); }
+
+  explicit CardinalityData(size_t cardinality) : values(data.values.size()) {
+    std::mt19937 gen;
+    std::uniform_int_distribution<size_t> dist(0, cardinality - 1);
+    for (auto& value : values) {
+      value = data.values[dist(gen)];
+      digest += compute_digest(fmt::format("{}", value));
+    }
+  }
+
+  static const CardinalityData& Get(size_t cardinality) {
+    static std::map<size_t, CardinalityData> cache;
+    auto it = cache.find(cardinality);
+    if (it == cache.end()) it = cache.emplace(cardinality, CardinalityData(cardinality)).first;
+    return it->second;
+  }
+};
+
+template<typename F>
+void ToStringCardinality(benchmark::State& state, F f) {
+  const auto& values = CardinalityData::Get(state.range(0));
+  auto dc = DigestChecker(state, values.digest);
+  for (auto s : state) {
+    for (auto value : values) {
+      char buf[16];
+      auto size = f(value, buf);
+      dc.add({buf, size});
+    }
+  }
+}
+
+// The same formatters through a format_cache, which hands back the cached
+// text instead of writing it to a buffer.
+template<typename F>
+void ToStringCached(benchmark::State& state, F f) {
+  const auto& values = CardinalityData::Get(state.range(0));
+  format_cache<int, F> cache(f);
+  auto dc = DigestChecker(state, values.digest);
+  for (auto s : state) {
+    for (auto value : values) {
+      dc.add(cache(value));
+    }
+  }
+}
+
+void Cardinalities(benchmark::internal::Benchmark* b) {
+  b->ArgName("cardinality");
+  for (int64_t cardinality = 1; cardinality <= 1'000'000; cardinality *= 10) {
+    b->Arg(cardinality);
+  }
+}
+
+#define BENCHMARK_CARDINALITY(Func)                                                                \
+  BENCHMARK_CAPTURE(ToStringCardinality, Func, imp::Func)->Name(#Func)->Apply(Cardinalities);      \
+  BENCHMARK_CAPTURE(ToStringCached, Func, imp::Func)->Name("cached/" #Func)->Apply(Cardinalities)
+
+BENCHMARK_CARDINALITY(sprintf);
+#if __has_include(<charconv>)
+BENCHMARK_CARDINALITY(to_chars);
+#endif
+BENCHMARK_CARDINALITY(format);
+
+// Dense sequential ranges, such as sequence numbers, starting from a random
+// value with the given number of digits.
+uint64_t SequentialStart(int64_t digits) {
+  const auto start = static_cast<uint64_t>(std::pow(10, digits - 1));
+  std::mt19937_64 gen;
+  return start + gen() % start;
+}
+
+template<typename F>
+void Sequential(benchmark::State& state, F f) {
+  uint64_t v = SequentialStart(state.range(0));
+  char buf[20];
+  size_t size = 0;
+  for (auto _ : state) {
+    size = f(v++, buf);
+    benchmark::DoNotOptimize(buf);
+  }
+  if (std::string_view{buf, size} != fmt::format("{}", v - 1))
+    throw std::logic_error("invalid sequence number");
+  state.SetItemsProcessed(state.iterations());
+}
+
+// The text of the previous number incremented in place, then copied out like
+// the formatters' output.
+void SequentialOdometer(benchmark::State& state) {
+  uint64_t v = SequentialStart(state.range(0));
+  decimal_odometer odometer(v);
+  char buf[20];
+  for (auto _ : state) {
+    std::memcpy(buf, odometer.data(), odometer.size());
+    benchmark::DoNotOptimize(buf);
+    ++odometer;
+    ++v;
+  }
+  if (odometer.view() != fmt::format("{}", v))
+    throw std::logic_error("invalid sequence number");
+  state.SetItemsProcessed(state.iterations());
+}
+
+void SequentialDigits(benchmark::internal::Benchmark* b) {
+  b->ArgName("digits");
+  for (int64_t digits : {1, 4, 8, 12, 16, 19}) {
+    b->Arg(digits);
+  }
+}
+
+#define BENCHMARK_SEQUENTIAL(Func) BENCHMARK_CAPTURE(Sequential, Func, imp::Func)->Name("sequential/" #Func)->Apply(SequentialDigits)
+
+#if __has_include(<charconv>)
+BENCHMARK_SEQUENTIAL(to_chars);
+#endif
+BENCHMARK_SEQUENTIAL(format);
+BENCHMARK_SEQUENTIAL(lut);
+BENCHMARK(SequentialOdometer)->Name("sequential/odometer")->Apply(SequentialDigits);
+
+namespace imp::append {
+
+// Appending each value to one growing string, as real output code does.
+
+#if __has_include(<charconv>)
+struct {
+void operator()(std::string& out, int d) {
+  char buf[std::numeric_limits<int>::digits10 + 2];
+  const auto [end, _] = std::to_chars(std::begin(buf), std::end(buf), d);
+  out.append(buf, end);
+}
+} to_chars;
+#endif
+
+struct {
+void operator()(std::string& out, int d) {
+  fmt::format_to(std::back_inserter(out), "{}", d);
+}
+} format_to;
+
+struct {
+void operator()(std::string& out, int d) {
+  fmt::format_int f(d);
+  out.append(f.data(), f.size());
+}
+} format_int;
+
+#if defined(__cpp_lib_format)
+struct {
+void operator()(std::string& out, int d) {
+  std::format_to(std::back_inserter(out), "{}", d);
+}
+} std_format_to;
+#endif
+
+struct {
+void operator()(std::string& out, int d) {
+  out += std::to_string(d);
+}
+} to_string;
+
+struct {
+void operator()(std::string& out, int d) {
+  boost::spirit::karma::generate(std::back_inserter(out), generator, d);
+}
+boost::spirit::karma::int_generator<int> generator;
+} karma;
+
+}
+
+// How the output string is reserved: not at all, exactly the final size up
+// front, or doubled whenever less than one value's room is left.
+enum class Reserve { none, exact, geometric };
+
+template<typename F>
+void Append(benchmark::State& state, F f, Reserve reserve) {
+  constexpr size_t kMaxSize = std::numeric_limits<int>::digits10 + 2;
+  static const size_t total = std::accumulate(data.begin(), data.end(), size_t(), [](size_t lhs, int rhs) {
+    return lhs + fmt::formatted_size("{}", rhs);
+  });
+  auto dc = DigestChecker(state);
+  for (auto s : state) {
+    std::string out;
+    if (reserve == Reserve::exact) out.reserve(total);
+    for (auto value : data) {
+      if (reserve == Reserve::geometric && out.capacity() - out.size() < kMaxSize)
+        out.reserve(2 * out.capacity() + kMaxSize);
+      f(out, value);
+    }
+    dc.add(out);
+  }
+}
+
+#define BENCHMARK_APPEND(Func)                                                                     \
+  BENCHMARK_CAPTURE(Append, Func##_none, imp::append::Func, Reserve::none)                         \
+      ->Name("append/" #Func "/none");                                                             \
+  BENCHMARK_CAPTURE(Append, Func##_exact, imp::append::Func, Reserve::exact)                       \
+      ->Name("append/" #Func "/exact");                                                            \
+  BENCHMARK_CAPTURE(Append, Func##_geometric, imp::append::Func, Reserve::geometric)               \
+      ->Name("append/" #Func "/geometric")
+
+#if __has_include(<charconv>)
+BENCHMARK_APPEND(to_chars);
+#endif
+BENCHMARK_APPEND(format_to);
+BENCHMARK_APPEND(format_int);
+#if defined(__cpp_lib_format)
+BENCHMARK_APPEND(std_format_to);
+#endif
+BENCHMARK_APPEND(to_string);
+BENCHMARK_APPEND(karma);
+
+// The digest alone, over the formatted data, for calibration.
+static void Digest(benchmark::State& state) {
+  static const auto texts = [] {
+    std::vector<std::string> texts;
+    texts.reserve(data.values.size());
+    for (auto value : data) texts.push_back(fmt::format("{}", value));
+    return texts;
+  }();
+  auto dc = DigestChecker(state);
+  for (auto s : state) {
+    for (const auto& text : texts) {
+      dc.add(text);
+    }
+  }
+}
+BENCHMARK(Digest);
 
 static void Noop(benchmark::State& state) {
   for (auto _ : state) benchmark::DoNotOptimize(0);
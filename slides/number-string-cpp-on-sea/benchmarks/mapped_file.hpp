@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only memory mapping of a whole file.
+class mapped_file {
+public:
+  explicit mapped_file(const std::filesystem::path& path) {
+#ifdef _WIN32
+    const handle file{::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr)};
+    if (file.h == INVALID_HANDLE_VALUE) fail("CreateFile");
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file.h, &size)) fail("GetFileSizeEx");
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ != 0) {
+      const handle mapping{::CreateFileMappingW(file.h, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+      if (mapping.h == nullptr) fail("CreateFileMapping");
+      data_ = static_cast<const char*>(::MapViewOfFile(mapping.h, FILE_MAP_READ, 0, 0, 0));
+      if (data_ == nullptr) fail("MapViewOfFile");
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) fail("open");
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      fail("fstat");
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ != 0) {
+      void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        ::close(fd);
+        fail("mmap");
+      }
+      ::madvise(data, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char*>(data);
+    }
+    ::close(fd);
+#endif
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  ~mapped_file() {
+    if (data_ == nullptr) return;
+#ifdef _WIN32
+    ::UnmapViewOfFile(data_);
+#else
+    ::munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+  std::string_view view() const { return {data_, size_}; }
+
+private:
+#ifdef _WIN32
+  // Closes the handle on every path out of the constructor. The error code is
+  // read when the exception is thrown, before the handles are closed.
+  struct handle {
+    explicit handle(HANDLE h) : h(h) {}
+    handle(const handle&) = delete;
+    handle& operator=(const handle&) = delete;
+    ~handle() {
+      if (h != nullptr && h != INVALID_HANDLE_VALUE) ::CloseHandle(h);
+    }
+    HANDLE h;
+  };
+#endif
+
+  [[noreturn]] static void fail(const char* what) {
+#ifdef _WIN32
+    throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), what);
+#else
+    throw std::system_error(errno, std::generic_category(), what);
+#endif
+  }
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+
+#include "parallel_parse.hpp"
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 64MB of newline-separated values, integers as in atoi's data and doubles
+// as in atod-digit's pipeline.
+template<typename T>
+const std::string& Buffer() {
+  static const std::string buffer = [] {
+    fmt::memory_buffer out;
+    std::mt19937 gen;
+    while (out.size() < (64 << 20)) {
+      if constexpr (std::is_integral_v<T>) {
+        std::uniform_int_distribution<int> dist(0, RAND_MAX);
+        int scale = dist(gen) / 100 + 1;
+        fmt::format_to(std::back_inserter(out), "{}\n", static_cast<int>(dist(gen) * dist(gen)) / scale);
+      } else {
+        std::uniform_real_distribution<T> dist;
+        fmt::format_to(std::back_inserter(out), "{}\n", dist(gen));
+      }
+    }
+    return fmt::to_string(out);
+  }();
+  return buffer;
+}
+
+template<typename T>
+std::vector<T> ParseSerial(const std::string& buffer) {
+  std::vector<T> values;
+  for_each_token(buffer.data(), buffer.data() + buffer.size(), '\n', [&](const char* str, size_t len) {
+    if (len != 0) values.push_back(from_chars_parser<T>{}(str, len));
+  });
+  return values;
+}
+
+template<typename T>
+void Serial(benchmark::State& state) {
+  const auto& buffer = Buffer<T>();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ParseSerial<T>(buffer));
+  }
+  state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+template<typename T>
+void Parallel(benchmark::State& state) {
+  const auto& buffer = Buffer<T>();
+  work_stealing_pool pool(static_cast<unsigned>(state.range(0)));
+  if (parallel_parse<T>(buffer, pool) != ParseSerial<T>(buffer))
+    throw std::logic_error("parallel result differs from serial");
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(parallel_parse<T>(buffer, pool));
+  }
+  state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+void Threads(benchmark::internal::Benchmark* b) {
+  b->ArgName("threads");
+  const auto max = std::max(std::thread::hardware_concurrency(), 1u);
+  for (unsigned threads = 1; threads < max; threads *= 2) {
+    b->Arg(threads);
+  }
+  b->Arg(max);
+}
+
+BENCHMARK_TEMPLATE(Serial, int64_t)->Name("int64_t/serial")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Parallel, int64_t)->Name("int64_t/parallel")->Apply(Threads)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Serial, double)->Name("double/serial")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Parallel, double)->Name("double/parallel")->Apply(Threads)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
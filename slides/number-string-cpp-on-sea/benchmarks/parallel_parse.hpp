@@ -0,0 +1,60 @@
+#pragma once
+
+#include "pipeline.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Parses a whole token with std::from_chars, throwing on malformed input.
+template<typename T>
+struct from_chars_parser {
+  T operator()(const char* str, size_t len) const {
+    T res{};
+    const auto [end, ec] = std::from_chars(str, str + len, res);
+    if (ec != std::errc{} || end != str + len) {
+      throw std::invalid_argument("cannot parse '" + std::string{str, len} + "'");
+    }
+    return res;
+  }
+};
+
+// Parses a buffer of newline-separated numbers on pool and returns them in
+// order. The buffer is cut into chunks of about chunk_size bytes at line
+// boundaries, each chunk is parsed into its own vector, and the vectors are
+// then copied into the result, both steps in parallel. Empty lines are
+// skipped.
+template<typename T, typename Parse = from_chars_parser<T>>
+std::vector<T> parallel_parse(std::string_view buffer, work_stealing_pool& pool, Parse parse = {},
+                              size_t chunk_size = 1 << 20) {
+  std::vector<std::string_view> chunks;
+  for (size_t begin = 0; begin < buffer.size();) {
+    auto end = buffer.find('\n', std::min(begin + chunk_size, buffer.size()) - 1);
+    end = end == std::string_view::npos ? buffer.size() : end + 1;
+    chunks.push_back(buffer.substr(begin, end - begin));
+    begin = end;
+  }
+
+  std::vector<std::vector<T>> parsed(chunks.size());
+  pool.for_each_index(chunks.size(), [&](size_t i) {
+    const auto chunk = chunks[i];
+    auto& values = parsed[i];
+    for_each_token(chunk.data(), chunk.data() + chunk.size(), '\n', [&](const char* str, size_t len) {
+      if (len != 0) values.push_back(parse(str, len));
+    });
+  });
+
+  std::vector<size_t> offsets(parsed.size() + 1);
+  for (size_t i = 0; i < parsed.size(); ++i) {
+    offsets[i + 1] = offsets[i] + parsed[i].size();
+  }
+  std::vector<T> res(offsets.back());
+  pool.for_each_index(parsed.size(), [&](size_t i) {
+    std::copy(parsed[i].begin(), parsed[i].end(), res.begin() + offsets[i]);
+  });
+  return res;
+}
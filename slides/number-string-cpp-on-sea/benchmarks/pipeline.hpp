@@ -0,0 +1,55 @@
+#pragma once
+
+#include "corpus.hpp"
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+
+// Calls f(str, len) for every delim-terminated token in [first, last).
+// memchr is vectorized by the C library, so scanning for the delimiter runs
+// at memory speed and the cost left to measure is the parser's.
+template<typename F>
+void for_each_token(const char* first, const char* last, char delim, F f) {
+  while (first < last) {
+    auto end = static_cast<const char*>(std::memchr(first, delim, last - first));
+    if (end == nullptr) end = last;
+    f(first, static_cast<size_t>(end - first));
+    first = end + 1;
+  }
+}
+
+// Size of the pipeline benchmark input, 2GB unless overridden in MB by the
+// PIPELINE_SIZE_MB environment variable.
+inline uintmax_t pipeline_size() {
+  const char* mb = std::getenv("PIPELINE_SIZE_MB");
+  return (mb != nullptr ? std::strtoull(mb, nullptr, 10) : 2048) << 20;
+}
+
+// A newline-delimited corpus of at least pipeline_size() bytes, generated
+// on first use by appending values with append(buffer), where append is
+// make_append(seed), and mapped by later runs. The size is part of the
+// file name, so each size has its own file.
+template<typename MakeAppend>
+corpus pipeline_file(const std::string& name, uint32_t schema, uint32_t seed, MakeAppend make_append) {
+  const auto size = pipeline_size();
+  return corpus{fmt::format("{}-{}MB.corpus", name, size >> 20), schema, seed,
+                [&](fmt::memory_buffer& buffer, uint32_t engine_seed, auto& flush) {
+                  auto append = make_append(engine_seed);
+                  uint64_t count = 0;
+                  for (uintmax_t written = 0; written < size;) {
+                    while (buffer.size() < (1 << 20)) {
+                      append(buffer);
+                      buffer.push_back('\n');
+                      ++count;
+                    }
+                    written += buffer.size();
+                    flush();
+                  }
+                  return std::pair<uint64_t, uint64_t>{count, 0};
+                }};
+}
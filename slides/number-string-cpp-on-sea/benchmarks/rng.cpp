@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+
+#include "rng.hpp"
+#include "simd_mt19937.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Generating a corpus of random doubles one call at a time, in bulk and
+// split between threads, which must all give the same values, the same as
+// std::mt19937's for simd::mt19937.
+
+const size_t kCount = 16 << 20;
+
+template<typename Engine>
+void Serial(benchmark::State& state) {
+  std::vector<double> values(kCount);
+  for (auto _ : state) {
+    Rng<double, Engine> rng;
+    std::generate(values.begin(), values.end(), std::ref(rng));
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kCount);
+}
+
+// Reference is the engine whose serial values the result must match, the
+// library's for simd::mt19937.
+template<typename Engine, typename Reference = Engine>
+void Fill(benchmark::State& state) {
+  std::vector<double> serial(kCount), values(kCount);
+  {
+    Rng<double, Reference> rng;
+    std::generate(serial.begin(), serial.end(), std::ref(rng));
+  }
+  for (auto _ : state) {
+    Rng<double, Engine> rng;
+    rng.fill(std::span{values});
+    benchmark::DoNotOptimize(values.data());
+  }
+  if (values != serial)
+    throw std::logic_error("bulk result differs from serial");
+  state.SetItemsProcessed(state.iterations() * kCount);
+}
+
+template<typename Engine, typename Reference = Engine>
+void Parallel(benchmark::State& state) {
+  const auto threads = static_cast<unsigned>(state.range(0));
+  std::vector<double> serial(kCount), values(kCount);
+  {
+    Rng<double, Reference> rng;
+    std::generate(serial.begin(), serial.end(), std::ref(rng));
+  }
+  for (auto _ : state) {
+    Rng<double, Engine> rng;
+    generate_parallel(std::span{values}, rng, threads);
+    benchmark::DoNotOptimize(values.data());
+  }
+  if (values != serial)
+    throw std::logic_error("parallel result differs from serial");
+  state.SetItemsProcessed(state.iterations() * kCount);
+}
+
+// simd::mt19937 with each instruction set the CPU supports against
+// std::mt19937, one output at a time and in bulk, across several
+// regenerations of the state.
+static void Check(benchmark::State& state) {
+  const size_t kOutputs = 10 * 624 + 5;
+  for (auto _ : state) {
+    for (auto i : {simd::isa::scalar, simd::isa::avx2}) {
+      if (!simd::supported(i)) continue;
+      std::mt19937 reference;
+      std::vector<uint32_t> expected(kOutputs), values(kOutputs);
+      std::generate(expected.begin(), expected.end(), std::ref(reference));
+
+      simd::mt19937 bulk{simd::mt19937::default_seed, i};
+      // An odd first chunk, so that later ones start mid-state.
+      bulk.fill(std::span{values}.first(7));
+      bulk.fill(std::span{values}.subspan(7));
+      if (values != expected)
+        throw std::logic_error(std::string{"simd::mt19937 fill differs from std::mt19937 with "} +
+                               std::string{simd::name(i)});
+
+      simd::mt19937 serial{simd::mt19937::default_seed, i};
+      std::generate(values.begin(), values.end(), std::ref(serial));
+      if (values != expected)
+        throw std::logic_error(std::string{"simd::mt19937 differs from std::mt19937 with "} +
+                               std::string{simd::name(i)});
+    }
+  }
+}
+
+// The cost of skipping a thread's share, which for mt19937 grows with it.
+template<typename Engine>
+void Discard(benchmark::State& state) {
+  const auto n = static_cast<unsigned long long>(state.range(0));
+  for (auto _ : state) {
+    Rng<double, Engine> rng;
+    rng.discard(n);
+    benchmark::DoNotOptimize(rng());
+  }
+}
+
+void Threads(benchmark::internal::Benchmark* b) {
+  b->ArgName("threads");
+  const auto max = std::max(std::thread::hardware_concurrency(), 1u);
+  for (unsigned threads = 1; threads < max; threads *= 2) {
+    b->Arg(threads);
+  }
+  b->Arg(max);
+}
+
+BENCHMARK(Check)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(Serial, pcg32)->Name("pcg32/serial")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Parallel, pcg32)->Name("pcg32/parallel")->Apply(Threads)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Serial, std::mt19937)->Name("mt19937/serial")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Parallel, std::mt19937)->Name("mt19937/parallel")->Apply(Threads)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Fill, std::mt19937)->Name("mt19937/fill")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Serial, simd::mt19937)->Name("simd_mt19937/serial")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Fill, simd::mt19937, std::mt19937)->Name("simd_mt19937/fill")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Parallel, simd::mt19937, std::mt19937)->Name("simd_mt19937/parallel")->Apply(Threads)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(Discard, pcg32)->Name("pcg32/discard")->RangeMultiplier(64)->Range(1, 1 << 30);
+BENCHMARK_TEMPLATE(Discard, std::mt19937)->Name("mt19937/discard")->RangeMultiplier(64)->Range(1, 1 << 24);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// PCG32 (XSH-RR): a 64-bit LCG with a permuted 32-bit output.
+// https://www.pcg-random.org/
+//
+// Unlike std::mt19937, an LCG can jump ahead in O(log n): n steps of
+// x -> a * x + c compose into a single step with another a and c, built by
+// squaring.
+class pcg32 {
+public:
+  using result_type = uint32_t;
+
+  static constexpr uint64_t default_seed = 0x853c49e6748fea9bULL;
+  static constexpr uint64_t default_stream = 0xda3e39cb94b95bdbULL;
+
+  explicit pcg32(uint64_t seed = default_seed, uint64_t stream = default_stream)
+      : inc_{(stream << 1) | 1} {
+    step();
+    state_ += seed;
+    step();
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    const uint64_t old = state_;
+    step();
+    const auto xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+    const auto rot = static_cast<unsigned>(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+  }
+
+  void discard(unsigned long long n) {
+    uint64_t acc_mult = 1, acc_plus = 0;
+    uint64_t cur_mult = kMultiplier, cur_plus = inc_;
+    for (; n != 0; n >>= 1) {
+      if (n & 1) {
+        acc_mult *= cur_mult;
+        acc_plus = acc_plus * cur_mult + cur_plus;
+      }
+      cur_plus *= cur_mult + 1;
+      cur_mult *= cur_mult;
+    }
+    state_ = acc_mult * state_ + acc_plus;
+  }
+
+  friend bool operator==(const pcg32&, const pcg32&) = default;
+
+private:
+  static constexpr uint64_t kMultiplier = 6364136223846793005ULL;
+
+  void step() { state_ = state_ * kMultiplier + inc_; }
+
+  uint64_t state_ = 0;
+  uint64_t inc_;
+};
+
+// Uniform values of T: integers in [0, max] and floating points in [0, 1),
+// the default ranges of the standard distributions.
+//
+// Each value takes the same number of engine outputs, which the standard
+// distributions do not promise, so skipping n values is discarding a known
+// number of outputs and the sequence can be split between threads. With
+// pcg32 the skip is O(log n); std::mt19937 also works, in O(n).
+template<typename T, typename Engine = pcg32>
+class Rng {
+  static_assert(Engine::min() == 0 && Engine::max() == std::numeric_limits<uint32_t>::max(),
+                "the engine must produce 32 random bits");
+
+public:
+  // Engine outputs consumed by each value.
+  static constexpr unsigned kDraws = sizeof(T) > 4 ? 2 : 1;
+
+  explicit Rng(uint64_t seed = 0) : gen_(seed) {}
+
+  T operator()() {
+    uint64_t bits = gen_();
+    if constexpr (kDraws == 2) bits = (bits << 32) | gen_();
+    return from_bits(bits);
+  }
+
+  // The next out.size() values, as many calls would return. Engines with a
+  // fill(std::span<uint32_t>) of their own, like simd::mt19937, produce the
+  // outputs in bulk.
+  void fill(std::span<T> out) {
+    if constexpr (requires(std::span<uint32_t> words) { gen_.fill(words); }) {
+      uint32_t words[1024];
+      while (!out.empty()) {
+        const size_t count = std::min(out.size(), std::size(words) / kDraws);
+        gen_.fill(std::span{words, count * kDraws});
+        for (size_t i = 0; i < count; ++i) {
+          uint64_t bits = words[i * kDraws];
+          if constexpr (kDraws == 2) bits = (bits << 32) | words[i * kDraws + 1];
+          out[i] = from_bits(bits);
+        }
+        out = out.subspan(count);
+      }
+    } else {
+      std::generate(out.begin(), out.end(), [this] { return (*this)(); });
+    }
+  }
+
+  // Skips the next n values.
+  void discard(unsigned long long n) { gen_.discard(n * kDraws); }
+
+private:
+  static T from_bits(uint64_t bits) {
+    if constexpr (std::is_integral_v<T>) {
+      return static_cast<T>(bits & static_cast<uint64_t>(std::numeric_limits<T>::max()));
+    } else {
+      constexpr int kBits = std::numeric_limits<T>::digits;
+      return static_cast<T>(bits >> (kDraws * 32 - kBits)) * (T{1} / static_cast<T>(uint64_t{1} << kBits));
+    }
+  }
+
+  Engine gen_;
+};
+
+// Fills out with the values rng would produce serially, each of threads
+// filling a contiguous chunk from a copy of rng skipped to its start.
+// Advances rng past them.
+template<typename T, typename Engine>
+void generate_parallel(std::span<T> out, Rng<T, Engine>& rng,
+                       unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+  threads = std::max(threads, 1u);
+  const size_t chunk = (out.size() + threads - 1) / threads;
+  std::vector<std::jthread> workers;
+  for (size_t first = 0; first < out.size(); first += chunk) {
+    workers.emplace_back([=, r = rng]() mutable {
+      r.discard(first);
+      r.fill(out.subspan(first, std::min(chunk, out.size() - first)));
+    });
+  }
+  workers.clear();
+  rng.discard(out.size());
+}
@@ -0,0 +1,140 @@
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <scn/scn.h>
+
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Rows of "{} {} {}" with an int, a double and an int, like an id, a price
+// and a quantity, scanned into a struct.
+
+struct Row {
+  int id = 0;
+  double price = 0;
+  int quantity = 0;
+};
+
+namespace imp {
+
+struct {
+Row operator()(const std::string& line) {
+  Row row;
+  std::sscanf(line.c_str(), "%d %lf %d", &row.id, &row.price, &row.quantity);
+  return row;
+}
+} sscanf;
+
+struct {
+Row operator()(const std::string& line) {
+  std::istringstream in{line};
+  Row row;
+  in >> row.id >> row.price >> row.quantity;
+  return row;
+}
+} istringstream;
+
+struct {
+Row operator()(const std::string& line) {
+  Row row;
+  scn::scan(line, "{} {} {}", row.id, row.price, row.quantity);
+  return row;
+}
+} scan;
+
+struct {
+Row operator()(const std::string& line) {
+  Row row;
+  scn::scan_default(line, row.id, row.price, row.quantity);
+  return row;
+}
+} scan_default;
+
+#if __has_include(<charconv>)
+// Hand-written: from_chars for each field, skipping the separating spaces.
+struct {
+Row operator()(const std::string& line) {
+  Row row;
+  const char* first = line.data();
+  const char* last = first + line.size();
+  auto field = [&](auto& value) {
+    while (first != last && *first == ' ') ++first;
+    first = std::from_chars(first, last, value).ptr;
+  };
+  field(row.id);
+  field(row.price);
+  field(row.quantity);
+  return row;
+}
+} from_chars;
+#endif
+
+}
+
+// Field-wise sums, to check the scanned rows.
+struct RowSum {
+  int64_t id = 0;
+  double price = 0;
+  int64_t quantity = 0;
+
+  void add(const Row& row) {
+    id += row.id;
+    price += row.price;
+    quantity += row.quantity;
+  }
+
+  bool operator==(const RowSum&) const = default;
+};
+
+struct Rows {
+  std::vector<std::string> lines;
+  RowSum sum;
+
+  auto begin() const { return lines.begin(); }
+  auto end() const { return lines.end(); }
+
+  Rows() : lines(100'000) {
+    std::mt19937 gen;
+    std::uniform_int_distribution<int> id(0, 10'000'000), cents(1, 1'000'000), quantity(1, 10'000);
+    for (auto& line : lines) {
+      const Row row{id(gen), cents(gen) / 100.0, quantity(gen)};
+      line = fmt::format("{} {:.2f} {}", row.id, row.price, row.quantity);
+      sum.add(row);
+    }
+  }
+} rows;
+
+template<typename F>
+void Scan(benchmark::State& state, F f) {
+  RowSum sum;
+  for (auto _ : state) {
+    sum = {};
+    for (const auto& line : rows) {
+      sum.add(f(line));
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  if (sum != rows.sum)
+    throw std::logic_error("invalid rows");
+  state.SetItemsProcessed(state.iterations() * rows.lines.size());
+}
+
+#define BENCHMARK_SCAN(Func) BENCHMARK_CAPTURE(Scan, Func, imp::Func)->Name(#Func)
+
+BENCHMARK_SCAN(sscanf);
+BENCHMARK_SCAN(istringstream);
+BENCHMARK_SCAN(scan);
+BENCHMARK_SCAN(scan_default);
+#if __has_include(<charconv>)
+BENCHMARK_SCAN(from_chars);
+#endif
+
+BENCHMARK_MAIN();
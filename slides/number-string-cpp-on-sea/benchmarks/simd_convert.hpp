@@ -0,0 +1,218 @@
+#pragma once
+
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define SIMD_X86 0
+#endif
+
+// Integer and floating point converters written for several instruction sets
+// and built into the same binary. The best one the CPU supports is picked at
+// startup; the SIMD_ISA environment variable forces a lower one for testing.
+namespace simd {
+
+enum class isa { scalar, sse42, avx2, avx512 };
+
+inline std::string_view name(isa i) {
+  constexpr std::string_view names[] = {"scalar", "sse4.2", "avx2", "avx512"};
+  return names[static_cast<int>(i)];
+}
+
+inline bool supported(isa i) {
+#if SIMD_X86
+#if defined(__GNUC__)
+  switch (i) {
+  case isa::scalar: return true;
+  case isa::sse42: return __builtin_cpu_supports("sse4.2");
+  case isa::avx2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") &&
+           __builtin_cpu_supports("bmi2");
+  case isa::avx512:
+    return __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl") &&
+           __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+  }
+#elif defined(_MSC_VER)
+  int leaf1[4], leaf7[4];
+  __cpuid(leaf1, 1);
+  __cpuidex(leaf7, 7, 0);
+  const bool osxsave = leaf1[2] & (1 << 27);
+  const auto xcr0 = osxsave ? _xgetbv(0) : 0;
+  const bool sse42 = leaf1[2] & (1 << 20);
+  const bool avx2 = (xcr0 & 0x6) == 0x6 && (leaf7[1] & (1 << 5)) && (leaf7[1] & (1 << 3)) &&
+                    (leaf7[1] & (1 << 8));
+  const bool avx512 = avx2 && (xcr0 & 0xE6) == 0xE6 && (leaf7[1] & (1 << 30)) &&
+                      (leaf7[1] & (1u << 31));
+  switch (i) {
+  case isa::scalar: return true;
+  case isa::sse42: return sse42;
+  case isa::avx2: return avx2;
+  case isa::avx512: return avx512;
+  }
+#endif
+  return false;
+#else
+  return i == isa::scalar;
+#endif
+}
+
+// The most capable supported instruction set, or the one named by SIMD_ISA.
+inline isa selected() {
+  if (const char* forced = std::getenv("SIMD_ISA")) {
+    for (auto i : {isa::scalar, isa::sse42, isa::avx2, isa::avx512}) {
+      if (name(i) != forced) continue;
+      if (!supported(i)) {
+        throw std::runtime_error(std::string{"SIMD_ISA="} + forced + " is not supported by this CPU");
+      }
+      return i;
+    }
+    throw std::runtime_error(std::string{"unknown SIMD_ISA="} + forced);
+  }
+  for (auto i : {isa::avx512, isa::avx2, isa::sse42}) {
+    if (supported(i)) return i;
+  }
+  return isa::scalar;
+}
+
+struct converters {
+  // Parse a leading int/double, returning 0 on malformed or overflowing input.
+  int (*parse_int)(const char* str, size_t len);
+  double (*parse_double)(const char* str, size_t len);
+  // Writes value and returns the number of characters. out needs room for
+  // 16 characters.
+  size_t (*format_int)(int value, char* out);
+  // Same in base 16, with lowercase digits and a '-' for negative values as
+  // std::to_chars does. Digits are handled 16 at a time, out needs room for
+  // 17 characters.
+  int (*parse_hex)(const char* str, size_t len);
+  size_t (*format_hex)(int value, char* out);
+};
+
+namespace detail {
+
+constexpr char digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+constexpr uint64_t pow10[] = {1,
+                              10,
+                              100,
+                              1000,
+                              10000,
+                              100000,
+                              1000000,
+                              10000000,
+                              100000000,
+                              1000000000,
+                              10000000000,
+                              100000000000,
+                              1000000000000,
+                              10000000000000,
+                              100000000000000,
+                              1000000000000000,
+                              10000000000000000};
+
+inline size_t count_digits(uint32_t v) {
+  return 1 + (v >= 10) + (v >= 100) + (v >= 1000) + (v >= 10000) + (v >= 100000) +
+         (v >= 1000000) + (v >= 10000000);
+}
+
+inline size_t count_hex_digits(uint32_t v) {
+  size_t n = 1;
+  while (v >>= 4) ++n;
+  return n;
+}
+
+inline uint64_t byteswap64(uint64_t v) {
+#if defined(_MSC_VER)
+  return _byteswap_uint64(v);
+#else
+  return __builtin_bswap64(v);
+#endif
+}
+
+inline double from_chars_double(const char* str, size_t len) {
+  double res = 0;
+  std::from_chars(str, str + len, res);
+  return res;
+}
+
+}
+
+#define SIMD_PRAGMA(x) _Pragma(#x)
+#if defined(__clang__)
+#define SIMD_TARGET_BEGIN(features) \
+  SIMD_PRAGMA(clang attribute push(__attribute__((target(features))), apply_to = function))
+#define SIMD_TARGET_END SIMD_PRAGMA(clang attribute pop)
+#elif defined(__GNUC__)
+#define SIMD_TARGET_BEGIN(features) SIMD_PRAGMA(GCC push_options) SIMD_PRAGMA(GCC target(features))
+#define SIMD_TARGET_END SIMD_PRAGMA(GCC pop_options)
+#else
+#define SIMD_TARGET_BEGIN(features)
+#define SIMD_TARGET_END
+#endif
+
+namespace scalar {
+#define SIMD_LEVEL 0
+#include "simd_kernels.inl"
+#undef SIMD_LEVEL
+}
+
+#if SIMD_X86
+SIMD_TARGET_BEGIN("sse4.2")
+namespace sse42 {
+#define SIMD_LEVEL 1
+#include "simd_kernels.inl"
+#undef SIMD_LEVEL
+}
+SIMD_TARGET_END
+
+SIMD_TARGET_BEGIN("avx2,bmi,bmi2")
+namespace avx2 {
+#define SIMD_LEVEL 2
+#include "simd_kernels.inl"
+#undef SIMD_LEVEL
+}
+SIMD_TARGET_END
+
+SIMD_TARGET_BEGIN("avx512bw,avx512vl,bmi,bmi2")
+namespace avx512 {
+#define SIMD_LEVEL 3
+#include "simd_kernels.inl"
+#undef SIMD_LEVEL
+}
+SIMD_TARGET_END
+#endif
+
+inline const converters& converters_for(isa i) {
+  static const converters table[] = {
+    {scalar::parse_int, scalar::parse_double, scalar::format_int, scalar::parse_hex, scalar::format_hex},
+#if SIMD_X86
+    {sse42::parse_int, sse42::parse_double, sse42::format_int, sse42::parse_hex, sse42::format_hex},
+    {avx2::parse_int, avx2::parse_double, avx2::format_int, avx2::parse_hex, avx2::format_hex},
+    {avx512::parse_int, avx512::parse_double, avx512::format_int, avx512::parse_hex, avx512::format_hex},
+#endif
+  };
+  return table[static_cast<int>(i)];
+}
+
+// The converters for selected(), chosen on first use.
+inline const converters& dispatch() {
+  static const converters& c = converters_for(selected());
+  return c;
+}
+
+}
@@ -0,0 +1,286 @@
+// Converter kernels, included by simd_convert.hpp once per instruction set
+// inside namespace simd::<isa>, with SIMD_LEVEL set to 0 (scalar), 1 (SSE4.2),
+// 2 (AVX2) or 3 (AVX-512). The SIMD levels share the arithmetic and differ in
+// how they load, classify and store characters.
+
+// Parses the up to 16 leading digits of [p, p + len) into value and returns
+// how many there were.
+inline size_t digits(const char* p, size_t len, uint64_t& value) {
+  const size_t max = len < 16 ? len : 16;
+#if SIMD_LEVEL == 0
+  size_t n = 0;
+  value = 0;
+  for (; n < max && static_cast<unsigned>(p[n] - '0') < 10; ++n) {
+    value = value * 10 + static_cast<unsigned>(p[n] - '0');
+  }
+  return n;
+#else
+#if SIMD_LEVEL == 3
+  // Masked load never touches bytes past len; masked-out bytes read as zero
+  // and end the digit run.
+  const __m128i chunk = _mm_maskz_loadu_epi8(
+      static_cast<__mmask16>(_bzhi_u32(0xFFFF, static_cast<unsigned>(max))), p);
+  const __m128i d = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+  const size_t n = _tzcnt_u32(~static_cast<unsigned>(_mm_cmplt_epu8_mask(d, _mm_set1_epi8(10))));
+#else
+  // Read 16 bytes at once unless that could cross into an unmapped page.
+  __m128i chunk;
+  if ((reinterpret_cast<uintptr_t>(p) & 4095) <= 4096 - 16) {
+    chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  } else {
+    alignas(16) char buf[16] = {};
+    std::memcpy(buf, p, max);
+    chunk = _mm_load_si128(reinterpret_cast<const __m128i*>(buf));
+  }
+  const __m128i d = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+#if SIMD_LEVEL == 1
+  size_t n = static_cast<size_t>(
+      _mm_cmpistri(_mm_setr_epi8('0', '9', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), chunk,
+                   _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY));
+#else
+  const auto mask = static_cast<unsigned>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d)));
+  size_t n = _tzcnt_u32(~mask);
+#endif
+  if (n > max) n = max;
+#endif
+  // Right-align the n digits and zero the rest, then combine pairs, quads
+  // and octets of digits with multiply-adds.
+  const __m128i index = _mm_add_epi8(
+      _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+      _mm_set1_epi8(static_cast<char>(static_cast<int>(n) - 16)));
+  const __m128i aligned = _mm_shuffle_epi8(d, index);
+  const __m128i pairs = _mm_maddubs_epi16(
+      aligned, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+  const __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+  const __m128i octets = _mm_madd_epi16(_mm_packus_epi32(quads, quads),
+                                        _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+  value = static_cast<uint64_t>(static_cast<uint32_t>(_mm_cvtsi128_si32(octets))) * 100000000 +
+          static_cast<uint32_t>(_mm_extract_epi32(octets, 1));
+  return n;
+#endif
+}
+
+// Writes the last n of the 8 zero-padded digits of v < 10^8. Levels below
+// AVX-512 store 8 bytes regardless of n.
+inline void write8(uint32_t v, size_t n, char* out) {
+#if SIMD_LEVEL == 0
+  char buf[8];
+  for (int i = 6; i >= 0; i -= 2) {
+    std::memcpy(buf + i, detail::digit_pairs + (v % 100) * 2, 2);
+    v /= 100;
+  }
+  std::memcpy(out, buf + 8 - n, n);
+#else
+  // abcdefgh -> abcd, efgh -> a, ab, abc, abcd, e, ef, efg, efgh -> a..h with
+  // fixed-point reciprocal multiplications.
+  const __m128i abcdefgh = _mm_cvtsi32_si128(static_cast<int>(v));
+  const __m128i abcd = _mm_srli_epi64(_mm_mul_epu32(abcdefgh, _mm_set1_epi32(static_cast<int>(0xd1b71759))), 45);
+  const __m128i efgh = _mm_sub_epi32(abcdefgh, _mm_mul_epu32(abcd, _mm_set1_epi32(10000)));
+  const __m128i v1 = _mm_slli_epi64(_mm_unpacklo_epi16(abcd, efgh), 2);
+  const __m128i v2a = _mm_unpacklo_epi16(v1, v1);
+  const __m128i v2 = _mm_unpacklo_epi32(v2a, v2a);
+  const __m128i v3 = _mm_mulhi_epu16(
+      v2, _mm_setr_epi16(8389, 5243, 13108, static_cast<short>(32768), 8389, 5243, 13108,
+                         static_cast<short>(32768)));
+  const __m128i v4 = _mm_mulhi_epu16(
+      v3, _mm_setr_epi16(1 << 7, 1 << 11, 1 << 13, static_cast<short>(1 << 15), 1 << 7, 1 << 11,
+                         1 << 13, static_cast<short>(1 << 15)));
+  const __m128i v5 = _mm_slli_epi64(_mm_mullo_epi16(v4, _mm_set1_epi16(10)), 16);
+  const __m128i digits = _mm_sub_epi16(v4, v5);
+  const __m128i ascii =
+      _mm_add_epi8(_mm_packus_epi16(digits, _mm_setzero_si128()), _mm_set1_epi8('0'));
+  const __m128i shifted = _mm_shuffle_epi8(
+      ascii, _mm_add_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                          _mm_set1_epi8(static_cast<char>(8 - n))));
+#if SIMD_LEVEL == 3
+  _mm_mask_storeu_epi8(out, static_cast<__mmask16>(_bzhi_u32(0xFF, static_cast<unsigned>(n))), shifted);
+#else
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(out), shifted);
+#endif
+#endif
+}
+
+inline int parse_int(const char* str, size_t len) {
+  const char* p = str;
+  const char* end = str + len;
+  const bool negative = p != end && *p == '-';
+  p += negative;
+  // Leading zeros do not count towards overflow.
+  while (p != end && *p == '0') ++p;
+  uint64_t value;
+  const size_t n = digits(p, end - p, value);
+  if (n == 0 || n > 10 || value > static_cast<uint64_t>(INT_MAX) + negative) return 0;
+  return negative ? static_cast<int>(-static_cast<int64_t>(value)) : static_cast<int>(value);
+}
+
+// Exact for up to 19 significant digits whose value fits in a double's
+// mantissa (a single correctly rounded division); anything else falls back
+// to std::from_chars.
+inline double parse_double(const char* str, size_t len) {
+  const char* p = str;
+  const char* end = str + len;
+  const bool negative = p != end && *p == '-';
+  p += negative;
+  uint64_t integer, fraction = 0;
+  const size_t integer_digits = digits(p, end - p, integer);
+  p += integer_digits;
+  size_t fraction_digits = 0;
+  if (p != end && *p == '.') {
+    ++p;
+    fraction_digits = digits(p, end - p, fraction);
+    p += fraction_digits;
+  }
+  // No digits: "inf", "nan" or malformed.
+  if (integer_digits + fraction_digits == 0) return detail::from_chars_double(str, len);
+  if (integer_digits == 16 || fraction_digits == 16 || integer_digits + fraction_digits > 19 ||
+      (p != end && (*p == 'e' || *p == 'E'))) {
+    return detail::from_chars_double(str, len);
+  }
+  const uint64_t mantissa = integer * detail::pow10[fraction_digits] + fraction;
+  if (mantissa > (uint64_t{1} << 53)) return detail::from_chars_double(str, len);
+  const double res =
+      static_cast<double>(mantissa) / static_cast<double>(detail::pow10[fraction_digits]);
+  return negative ? -res : res;
+}
+
+inline size_t format_int(int value, char* out) {
+  char* p = out;
+  auto v = static_cast<uint32_t>(value);
+  if (value < 0) {
+    *p++ = '-';
+    v = 0 - v;
+  }
+  if (v >= 100000000) {
+    const uint32_t high = v / 100000000;
+    if (high >= 10) {
+      std::memcpy(p, detail::digit_pairs + high * 2, 2);
+      p += 2;
+    } else {
+      *p++ = static_cast<char>('0' + high);
+    }
+    write8(v % 100000000, 8, p);
+    return static_cast<size_t>(p + 8 - out);
+  }
+  const size_t n = detail::count_digits(v);
+  write8(v, n, p);
+  return static_cast<size_t>(p + n - out);
+}
+
+// Parses the up to 16 leading hexadecimal digits of [p, p + len) into value
+// and returns how many there were.
+inline size_t hex_digits(const char* p, size_t len, uint64_t& value) {
+  const size_t max = len < 16 ? len : 16;
+#if SIMD_LEVEL == 0
+  size_t n = 0;
+  value = 0;
+  for (; n < max; ++n) {
+    const unsigned c = static_cast<unsigned char>(p[n]);
+    unsigned nibble;
+    if (c - '0' < 10u) {
+      nibble = c - '0';
+    } else if ((c | 0x20) - 'a' < 6u) {
+      nibble = (c | 0x20) - 'a' + 10;
+    } else {
+      break;
+    }
+    value = value << 4 | nibble;
+  }
+  return n;
+#else
+#if SIMD_LEVEL == 3
+  const __m128i chunk = _mm_maskz_loadu_epi8(
+      static_cast<__mmask16>(_bzhi_u32(0xFFFF, static_cast<unsigned>(max))), p);
+#else
+  __m128i chunk;
+  if ((reinterpret_cast<uintptr_t>(p) & 4095) <= 4096 - 16) {
+    chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  } else {
+    alignas(16) char buf[16] = {};
+    std::memcpy(buf, p, max);
+    chunk = _mm_load_si128(reinterpret_cast<const __m128i*>(buf));
+  }
+#endif
+  // Nibble values: c - '0' for decimal digits, (c | 0x20) - 'a' + 10 for
+  // letters.
+  const __m128i decimal = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+  const __m128i letter = _mm_sub_epi8(_mm_or_si128(chunk, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+#if SIMD_LEVEL == 3
+  const __mmask16 is_decimal = _mm_cmplt_epu8_mask(decimal, _mm_set1_epi8(10));
+  const __mmask16 is_letter = _mm_cmplt_epu8_mask(letter, _mm_set1_epi8(6));
+  const __m128i nibbles = _mm_mask_blend_epi8(is_decimal, _mm_add_epi8(letter, _mm_set1_epi8(10)), decimal);
+  const size_t n = _tzcnt_u32(~static_cast<unsigned>(is_decimal | is_letter));
+#else
+  const __m128i is_decimal = _mm_cmpeq_epi8(_mm_min_epu8(decimal, _mm_set1_epi8(9)), decimal);
+  const __m128i nibbles = _mm_blendv_epi8(_mm_add_epi8(letter, _mm_set1_epi8(10)), decimal, is_decimal);
+#if SIMD_LEVEL == 1
+  size_t n = static_cast<size_t>(
+      _mm_cmpistri(_mm_setr_epi8('0', '9', 'a', 'f', 'A', 'F', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), chunk,
+                   _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY));
+#else
+  const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+  const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(is_decimal, is_letter)));
+  size_t n = _tzcnt_u32(~mask);
+#endif
+  if (n > max) n = max;
+#endif
+  // Right-align the n nibbles, join pairs into bytes and read them as a
+  // big-endian integer.
+  const __m128i index = _mm_add_epi8(
+      _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+      _mm_set1_epi8(static_cast<char>(static_cast<int>(n) - 16)));
+  const __m128i aligned = _mm_shuffle_epi8(nibbles, index);
+  const __m128i bytes = _mm_packus_epi16(
+      _mm_maddubs_epi16(aligned, _mm_set1_epi16(0x0110)), _mm_setzero_si128());
+  value = detail::byteswap64(static_cast<uint64_t>(_mm_cvtsi128_si64(bytes)));
+  return n;
+#endif
+}
+
+// Writes the last n of the 16 zero-padded hexadecimal digits of v. Levels
+// below AVX-512 store 16 bytes regardless of n.
+inline void write_hex16(uint64_t v, size_t n, char* out) {
+#if SIMD_LEVEL == 0
+  for (size_t i = n; i-- > 0; v >>= 4) {
+    out[i] = "0123456789abcdef"[v & 0xF];
+  }
+#else
+  const __m128i bytes = _mm_cvtsi64_si128(static_cast<long long>(detail::byteswap64(v)));
+  const __m128i low = _mm_and_si128(bytes, _mm_set1_epi8(0xF));
+  const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0xF));
+  const __m128i nibbles = _mm_unpacklo_epi8(high, low);
+  const __m128i ascii = _mm_shuffle_epi8(
+      _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'),
+      nibbles);
+  const __m128i shifted = _mm_shuffle_epi8(
+      ascii, _mm_add_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                          _mm_set1_epi8(static_cast<char>(16 - n))));
+#if SIMD_LEVEL == 3
+  _mm_mask_storeu_epi8(out, static_cast<__mmask16>(_bzhi_u32(0xFFFF, static_cast<unsigned>(n))), shifted);
+#else
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), shifted);
+#endif
+#endif
+}
+
+inline int parse_hex(const char* str, size_t len) {
+  const char* p = str;
+  const bool negative = len != 0 && *p == '-';
+  p += negative;
+  uint64_t value;
+  const size_t n = hex_digits(p, len - negative, value);
+  if (n == 0 || n > 8 || value > static_cast<uint64_t>(INT_MAX) + negative) return 0;
+  return negative ? static_cast<int>(-static_cast<int64_t>(value)) : static_cast<int>(value);
+}
+
+inline size_t format_hex(int value, char* out) {
+  char* p = out;
+  auto v = static_cast<uint32_t>(value);
+  if (value < 0) {
+    *p++ = '-';
+    v = 0 - v;
+  }
+  const size_t n = detail::count_hex_digits(v);
+  write_hex16(v, n, p);
+  return static_cast<size_t>(p + n - out);
+}
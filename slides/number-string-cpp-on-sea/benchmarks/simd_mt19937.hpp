@@ -0,0 +1,179 @@
+#pragma once
+
+#include "simd_convert.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+// A Mersenne Twister with the output of std::mt19937, whose state is
+// regenerated and tempered 8 words at a time with AVX2 when the CPU has it,
+// as picked by simd::selected().
+//
+// Regenerating word i reads words i + 1 and i + 397, so 8 consecutive words
+// only depend on words already regenerated or not yet touched, except
+// around the wraps at 227 and 624, which are done one at a time.
+namespace simd {
+
+namespace detail::mt {
+
+constexpr size_t n = 624;
+constexpr size_t m = 397;
+constexpr uint32_t matrix = 0x9908b0df;
+constexpr uint32_t upper = 0x80000000;
+constexpr uint32_t lower = 0x7fffffff;
+
+inline uint32_t twist(uint32_t cur, uint32_t next, uint32_t far) {
+  const uint32_t y = (cur & upper) | (next & lower);
+  return far ^ (y >> 1) ^ (-(y & 1) & matrix);
+}
+
+inline uint32_t temper(uint32_t y) {
+  y ^= y >> 11;
+  y ^= (y << 7) & 0x9d2c5680;
+  y ^= (y << 15) & 0xefc60000;
+  return y ^ (y >> 18);
+}
+
+inline void twist_range(uint32_t* state, size_t first, size_t last) {
+  for (size_t i = first; i < last; ++i) {
+    state[i] = twist(state[i], state[(i + 1) % n], state[(i + m) % n]);
+  }
+}
+
+inline void regenerate_scalar(uint32_t* state) { twist_range(state, 0, n); }
+
+inline void temper_scalar(const uint32_t* state, uint32_t* out, size_t count) {
+  for (size_t i = 0; i < count; ++i) out[i] = temper(state[i]);
+}
+
+#if SIMD_X86
+SIMD_TARGET_BEGIN("avx2")
+
+inline __m256i twist8(const uint32_t* cur, const uint32_t* far) {
+  const auto c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+  const auto next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + 1));
+  const auto f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(far));
+  const auto y = _mm256_or_si256(_mm256_and_si256(c, _mm256_set1_epi32(static_cast<int>(upper))),
+                                 _mm256_and_si256(next, _mm256_set1_epi32(static_cast<int>(lower))));
+  const auto odd = _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(y, _mm256_set1_epi32(1)));
+  const auto mag = _mm256_and_si256(odd, _mm256_set1_epi32(static_cast<int>(matrix)));
+  return _mm256_xor_si256(f, _mm256_xor_si256(_mm256_srli_epi32(y, 1), mag));
+}
+
+inline void regenerate_avx2(uint32_t* state) {
+  // Words [0, 224) read [1, 225) and [397, 621), none regenerated yet.
+  size_t i = 0;
+  for (; i + 8 <= n - m - 3; i += 8) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + i), twist8(state + i, state + i + m));
+  }
+  // Words [224, 232) read across the wrap of i + 397.
+  twist_range(state, i, i + 8);
+  // Words [232, 616) read [233, 617) and [5, 389), the latter regenerated.
+  for (i += 8; i + 8 <= n - 8; i += 8) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + i), twist8(state + i, state + i + m - n));
+  }
+  // Words [616, 624) read across the wrap of i + 1.
+  twist_range(state, i, n);
+}
+
+inline void temper_avx2(const uint32_t* state, uint32_t* out, size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + i));
+    y = _mm256_xor_si256(y, _mm256_srli_epi32(y, 11));
+    y = _mm256_xor_si256(y, _mm256_and_si256(_mm256_slli_epi32(y, 7), _mm256_set1_epi32(static_cast<int>(0x9d2c5680))));
+    y = _mm256_xor_si256(y, _mm256_and_si256(_mm256_slli_epi32(y, 15), _mm256_set1_epi32(static_cast<int>(0xefc60000))));
+    y = _mm256_xor_si256(y, _mm256_srli_epi32(y, 18));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), y);
+  }
+  temper_scalar(state + i, out + i, count - i);
+}
+
+SIMD_TARGET_END
+#endif
+
+struct kernels {
+  void (*regenerate)(uint32_t* state);
+  void (*temper)(const uint32_t* state, uint32_t* out, size_t count);
+};
+
+inline const kernels& kernels_for(isa i) {
+  static const kernels scalar{regenerate_scalar, temper_scalar};
+#if SIMD_X86
+  static const kernels avx2{regenerate_avx2, temper_avx2};
+  if (i >= isa::avx2) return avx2;
+#endif
+  return scalar;
+}
+
+// The kernels for selected(), chosen on first use.
+inline const kernels& dispatch() {
+  static const kernels& k = kernels_for(selected());
+  return k;
+}
+
+}
+
+class mt19937 {
+public:
+  using result_type = uint32_t;
+
+  static constexpr result_type default_seed = 5489u;
+
+  explicit mt19937(result_type seed = default_seed) : mt19937(seed, detail::mt::dispatch()) {}
+
+  // With the kernels of i, which must be supported, whatever selected()
+  // picks, to test each of them.
+  mt19937(result_type seed, isa i) : mt19937(seed, detail::mt::kernels_for(i)) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    if (index_ == detail::mt::n) regenerate();
+    return detail::mt::temper(state_[index_++]);
+  }
+
+  // The next out.size() outputs, as many calls would return.
+  void fill(std::span<uint32_t> out) {
+    const auto temper = kernels_->temper;
+    while (!out.empty()) {
+      if (index_ == detail::mt::n) regenerate();
+      const size_t count = std::min(detail::mt::n - index_, out.size());
+      temper(state_ + index_, out.data(), count);
+      index_ += count;
+      out = out.subspan(count);
+    }
+  }
+
+  void discard(unsigned long long count) {
+    while (count != 0) {
+      if (index_ == detail::mt::n) regenerate();
+      const auto skipped = std::min<unsigned long long>(detail::mt::n - index_, count);
+      index_ += static_cast<size_t>(skipped);
+      count -= skipped;
+    }
+  }
+
+private:
+  mt19937(result_type seed, const detail::mt::kernels& k) : kernels_(&k) {
+    state_[0] = seed;
+    for (uint32_t i = 1; i < detail::mt::n; ++i) {
+      state_[i] = 1812433253u * (state_[i - 1] ^ (state_[i - 1] >> 30)) + i;
+    }
+  }
+
+  void regenerate() {
+    kernels_->regenerate(state_);
+    index_ = 0;
+  }
+
+  const detail::mt::kernels* kernels_;
+  uint32_t state_[detail::mt::n];
+  size_t index_ = detail::mt::n;
+};
+
+}
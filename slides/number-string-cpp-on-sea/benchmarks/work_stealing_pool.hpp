@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size thread pool running indexed tasks. Each thread owns a queue,
+// initially holding a contiguous block of the indices, which it drains from
+// the front; threads that run dry steal from the back of the others' queues.
+// The calling thread takes part as thread 0.
+class work_stealing_pool {
+public:
+  explicit work_stealing_pool(unsigned threads = std::thread::hardware_concurrency())
+      : size_(std::max(threads, 1u)), queues_(std::make_unique<queue[]>(size_)) {
+    for (size_t i = 1; i < size_; ++i) {
+      workers_.emplace_back([this, i] { work(i); });
+    }
+  }
+
+  work_stealing_pool(const work_stealing_pool&) = delete;
+  work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+  ~work_stealing_pool() {
+    {
+      std::lock_guard lock{mutex_};
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) worker.join();
+  }
+
+  size_t size() const { return size_; }
+
+  // Calls f(i) for every i in [0, n) and returns when all calls are done.
+  // The first exception thrown by f is rethrown here.
+  template<typename F>
+  void for_each_index(size_t n, F f) {
+    if (n == 0) return;
+    task_ = std::ref(f);
+    error_ = nullptr;
+    remaining_ = n;
+    for (size_t i = 0; i < size_; ++i) {
+      std::lock_guard lock{queues_[i].mutex};
+      queues_[i].begin = n * i / size_;
+      queues_[i].end = n * (i + 1) / size_;
+    }
+    {
+      std::lock_guard lock{mutex_};
+      ++generation_;
+    }
+    wake_.notify_all();
+
+    run(0);
+    {
+      std::unique_lock lock{mutex_};
+      done_.wait(lock, [this] { return remaining_ == 0; });
+    }
+    if (error_) std::rethrow_exception(error_);
+  }
+
+private:
+  struct alignas(64) queue {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+  };
+
+  void work(size_t self) {
+    size_t seen = 0;
+    for (;;) {
+      {
+        std::unique_lock lock{mutex_};
+        wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) return;
+        seen = generation_;
+      }
+      run(self);
+    }
+  }
+
+  bool pop(size_t self, size_t& index) {
+    {
+      auto& own = queues_[self];
+      std::lock_guard lock{own.mutex};
+      if (own.begin != own.end) {
+        index = own.begin++;
+        return true;
+      }
+    }
+    for (size_t i = 1; i < size_; ++i) {
+      auto& victim = queues_[(self + i) % size_];
+      std::lock_guard lock{victim.mutex};
+      if (victim.begin != victim.end) {
+        index = --victim.end;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void run(size_t self) {
+    for (size_t index; pop(self, index);) {
+      try {
+        task_(index);
+      } catch (...) {
+        std::lock_guard lock{mutex_};
+        if (!error_) error_ = std::current_exception();
+      }
+      if (--remaining_ == 0) {
+        std::lock_guard lock{mutex_};
+        done_.notify_all();
+      }
+    }
+  }
+
+  const size_t size_;
+  std::unique_ptr<queue[]> queues_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  size_t generation_ = 0;
+  bool stop_ = false;
+
+  std::function<void(size_t)> task_;
+  std::atomic<size_t> remaining_ = 0;
+  std::exception_ptr error_;
+};
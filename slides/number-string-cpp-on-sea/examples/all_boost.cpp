@@ -13,6 +13,8 @@
 #include <boost/spirit/include/karma.hpp>
 #include <boost/spirit/include/qi.hpp>
 
+#include "convert_add.hpp"
+
 struct
 {
   template <typename T = double>
@@ -114,37 +116,6 @@ struct
   }
 } x3_karma;
 
-template <typename Converter>
-struct convert_
-{
-  template <typename T = double>
-  std::string operator()(std::string_view lhs, std::string_view rhs,
-                         int precision)
-  {
-    Converter ccnv;
-    namespace arg = boost::cnv::parameter;
-
-    // https://github.com/boostorg/convert/issues/53
-    using T_ = std::conditional_t<std::is_same_v<Converter, boost::cnv::printf>, float, double>;
-
-    const auto l = boost::convert<T_>(lhs, ccnv).value();
-    const auto r = boost::convert<T_>(rhs, ccnv).value();
-    if constexpr (std::is_invocable_v<Converter, decltype(arg::precision)>)
-    {
-      return boost::convert<std::string>(l + r,
-                                         ccnv(arg::precision = precision))
-          .value();
-    }
-    else
-    {
-      return boost::convert<std::string>(l + r, ccnv).value();
-    }
-  }
-};
-
-template <typename Converter>
-convert_<Converter> convert;
-
 int main()
 {
   static const int DEFAULT_PRECISION =
@@ -155,7 +126,7 @@ int main()
        rhs = fmt::format("{:.{}f}", 0.2, DEFAULT_PRECISION)](
           const std::string_view name, auto method)
   {
-    fmt::print("{:25}", name);
+    fmt::print("{:32}", name);
     if constexpr (std::is_invocable_v<decltype(method), const char *,
                                       const char *, char *, int>)
     {
@@ -174,7 +145,7 @@ int main()
     }
   };
 
-  fmt::print("{:25}{:.{}f}\n", "π", std::numbers::pi, DEFAULT_PRECISION);
+  fmt::print("{:32}{:.{}f}\n", "π", std::numbers::pi, DEFAULT_PRECISION);
   test("lexical_cast", lexical_cast);
   test("boost_format", boost_format);
   test("qi_karma", qi_karma);
@@ -184,4 +155,9 @@ int main()
   test("convert<lexical_cast>", convert<boost::cnv::lexical_cast>);
   test("convert<printf>", convert<boost::cnv::printf>);
   test("convert<spirit>", convert<boost::cnv::spirit>);
+  test("convert_hoisted<cstream>", convert_hoisted<boost::cnv::cstream>);
+  test("convert_hoisted<strtol>", convert_hoisted<boost::cnv::strtol>);
+  test("convert_hoisted<lexical_cast>", convert_hoisted<boost::cnv::lexical_cast>);
+  test("convert_hoisted<printf>", convert_hoisted<boost::cnv::printf>);
+  test("convert_hoisted<spirit>", convert_hoisted<boost::cnv::spirit>);
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <boost/convert.hpp>
+#include <boost/convert/lexical_cast.hpp>
+#include <boost/convert/printf.hpp>
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// String add(String lhs, String rhs) through boost::convert, shared by
+// all_boost.cpp and the benchmarks.
+
+template <typename Converter>
+std::string convert_add(Converter &ccnv, std::string_view lhs,
+                        std::string_view rhs, int precision)
+{
+  namespace arg = boost::cnv::parameter;
+
+  // https://github.com/boostorg/convert/issues/53
+  using T_ = std::conditional_t<std::is_same_v<Converter, boost::cnv::printf>, float, double>;
+
+  const auto l = boost::convert<T_>(lhs, ccnv).value();
+  const auto r = boost::convert<T_>(rhs, ccnv).value();
+  // lexical_cast is the only converter without parameters
+  if constexpr (!std::is_same_v<Converter, boost::cnv::lexical_cast>)
+  {
+    return boost::convert<std::string>(l + r,
+                                       ccnv(arg::precision = int{precision}))
+        .value();
+  }
+  else
+  {
+    return boost::convert<std::string>(l + r, ccnv).value();
+  }
+}
+
+template <typename Converter>
+struct convert_
+{
+  std::string operator()(std::string_view lhs, std::string_view rhs,
+                         int precision)
+  {
+    Converter ccnv;
+    return convert_add(ccnv, lhs, rhs, precision);
+  }
+};
+
+template <typename Converter>
+convert_<Converter> convert;
+
+// reuses one converter per thread instead of constructing one, and for
+// cstream its stringstream, on every call
+template <typename Converter>
+struct convert_hoisted_
+{
+  std::string operator()(std::string_view lhs, std::string_view rhs,
+                         int precision)
+  {
+    thread_local Converter ccnv;
+    return convert_add(ccnv, lhs, rhs, precision);
+  }
+};
+
+template <typename Converter>
+convert_hoisted_<Converter> convert_hoisted;
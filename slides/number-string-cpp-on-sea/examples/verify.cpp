@@ -5,16 +5,24 @@
 #include <boost/spirit/include/qi.hpp>
 #include <boost/spirit/include/phoenix_core.hpp>
 #include <boost/spirit/include/phoenix_operator.hpp>
+#include <algorithm>
 #include <cassert>
 #include <charconv>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <iomanip>
 #include <numbers>
+#include <numeric>
 #include <random>
+#include <span>
 #include <sstream>
 #include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../benchmarks/rng.hpp"
 
 constexpr int DEFAULT_PRECISION = 17;
 
@@ -29,21 +37,6 @@ void error(Format &&format, Args &&...args) {
       fmt::format(format, std::forward<Args>(args)...));
 }
 
-template <typename T>
-class Rng {
- public:
-  explicit Rng(unsigned seed = 0) : gen_{seed} {}
-
-  T operator()() { return dist_(gen_); }
-
- private:
-  std::mt19937 gen_;
-  using dist = std::conditional_t<std::is_integral_v<T>,
-                                  std::uniform_int_distribution<T>,
-                                  std::uniform_real_distribution<T>>;
-  dist dist_;
-};
-
 template <typename Method>
 static size_t verifyValue(double value, Method method,
                           const std::string_view expect = "") {
@@ -90,22 +83,42 @@ static void verify(const std::string_view fname, Method method) try {
   verifyValue(std::numeric_limits<double>::max(), method);
   verifyValue(std::numeric_limits<double>::denorm_min(), method);
 
-  Rng<double> r;
-
+  // The random values are drawn and verified on every core. Each thread
+  // keeps its own lengths and the first error it hits.
   constexpr unsigned kVerifyRandomCount = 100000;
 
-  uint64_t lenSum = 0;
-  size_t lenMax = 0;
-  for (unsigned i = 0; i < kVerifyRandomCount; i++) {
-    double d;
-    do {
-      d = r();
-    } while (std::isnan(d) || std::isinf(d));
-    size_t len = verifyValue(d, method);
-    lenSum += len;
-    lenMax = std::max(lenMax, len);
+  std::vector<double> values(kVerifyRandomCount);
+  Rng<double> r;
+  generate_parallel(std::span{values}, r);
+
+  const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  const size_t chunk = (values.size() + threads - 1) / threads;
+  std::vector<uint64_t> lenSums(threads);
+  std::vector<size_t> lenMaxes(threads);
+  std::vector<std::exception_ptr> errors(threads);
+  {
+    std::vector<std::jthread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+      workers.emplace_back([&, t] {
+        try {
+          const size_t last = std::min(values.size(), (t + 1) * chunk);
+          for (size_t i = t * chunk; i < last; i++) {
+            size_t len = verifyValue(values[i], method);
+            lenSums[t] += len;
+            lenMaxes[t] = std::max(lenMaxes[t], len);
+          }
+        } catch (...) {
+          errors[t] = std::current_exception();
+        }
+      });
+    }
+  }
+  for (auto &e : errors) {
+    if (e) std::rethrow_exception(e);
   }
 
+  uint64_t lenSum = std::accumulate(lenSums.begin(), lenSums.end(), uint64_t{0});
+  size_t lenMax = *std::max_element(lenMaxes.begin(), lenMaxes.end());
   double lenAvg = double(lenSum) / kVerifyRandomCount;
   fmt::print("OK. Length Avg = {:2.3f}, Max = {}\n", lenAvg, lenMax);
 } catch (const std::exception &ex) {
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include "alias.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Building and sampling a discrete distribution of state.range(0) weights,
+// with the library's binary search over the cumulative weights and with an
+// alias table.
+
+const std::vector<double>& Weights(size_t n) {
+  // Skewed, like the load of a few hot keys among many.
+  static std::vector<double> weights;
+  if (weights.size() != n) {
+    std::mt19937_64 e;
+    std::exponential_distribution<> d;
+    weights.resize(n);
+    for (auto& w : weights) w = std::pow(d(e), 4);
+  }
+  return weights;
+}
+
+template<typename Distribution>
+void Construct(benchmark::State& state) {
+  const auto& weights = Weights(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    Distribution d(weights.begin(), weights.end());
+    benchmark::DoNotOptimize(d);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename Distribution>
+void Sample(benchmark::State& state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const auto& weights = Weights(n);
+  Distribution d(weights.begin(), weights.end());
+  std::mt19937_64 e;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(d(e));
+  }
+
+  // The counts should match the probabilities within 6 standard errors,
+  // give or take a few hits on the tiniest weights.
+  const size_t kSamples = 1'000'000;
+  std::vector<size_t> counts(n);
+  for (size_t i = 0; i < kSamples; ++i) ++counts[static_cast<size_t>(d(e))];
+  const auto probabilities = d.probabilities();
+  for (size_t i = 0; i < n; ++i) {
+    const double expected = probabilities[i] * kSamples;
+    if (std::abs(static_cast<double>(counts[i]) - expected) > 6 * std::sqrt(expected) + 6)
+      throw std::logic_error("frequencies differ from the weights");
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void Sizes(benchmark::internal::Benchmark* b) {
+  b->ArgName("n")->RangeMultiplier(16)->Range(16, 1 << 20);
+}
+
+#define BENCHMARK_DISCRETE(Label, Distribution)                                         \
+  BENCHMARK_TEMPLATE(Construct, Distribution)->Name(#Label "/construct")->Apply(Sizes); \
+  BENCHMARK_TEMPLATE(Sample, Distribution)->Name(#Label "/sample")->Apply(Sizes)
+
+BENCHMARK_DISCRETE(std, std::discrete_distribution<>);
+BENCHMARK_DISCRETE(alias, alias::discrete_distribution<>);
+
+BENCHMARK_MAIN();
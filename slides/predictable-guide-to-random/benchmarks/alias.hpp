@@ -0,0 +1,149 @@
+#pragma once
+
+#include "random_bits.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <numeric>
+#include <vector>
+
+// A discrete distribution sampled in constant time by Walker's alias
+// method, with the tables built by Vose's algorithm.
+// https://www.keithschwarz.com/darts-dice-coins/
+//
+// Each of the n columns holds 1/n of the probability: some of its own
+// index's and, unless that fills it, some of one other index, its alias. A
+// sample picks a column and tosses a coin weighted by the column's own
+// share, from one 64-bit word: the high half picks the column by
+// multiply-shift, the low half is the coin.
+namespace alias {
+
+template<typename IntType = int>
+class discrete_distribution {
+public:
+  using result_type = IntType;
+
+  class param_type {
+  public:
+    using distribution_type = discrete_distribution;
+
+    param_type() : param_type({1.0}) {}
+
+    template<typename InputIt>
+    param_type(InputIt first, InputIt last) : probabilities_(first, last) {
+      if (probabilities_.empty()) probabilities_ = {1.0};
+      build();
+    }
+
+    param_type(std::initializer_list<double> weights) : param_type(weights.begin(), weights.end()) {}
+
+    template<typename UnaryOperation>
+    param_type(size_t count, double xmin, double xmax, UnaryOperation fw) {
+      const size_t n = count == 0 ? 1 : count;
+      const double delta = (xmax - xmin) / static_cast<double>(n);
+      probabilities_.reserve(n);
+      for (size_t k = 0; k < n; ++k) probabilities_.push_back(fw(xmin + static_cast<double>(k) * delta + delta / 2));
+      build();
+    }
+
+    std::vector<double> probabilities() const { return probabilities_; }
+
+    friend bool operator==(const param_type& lhs, const param_type& rhs) {
+      return lhs.probabilities_ == rhs.probabilities_;
+    }
+
+  private:
+    friend discrete_distribution;
+
+    struct column {
+      // The own share, out of 2^32; a full column is its own alias.
+      uint32_t threshold;
+      uint32_t alias;
+    };
+
+    void build() {
+      const double sum = std::accumulate(probabilities_.begin(), probabilities_.end(), 0.0);
+      for (auto& p : probabilities_) p /= sum;
+
+      const size_t n = probabilities_.size();
+      std::vector<double> scaled(n);
+      std::vector<uint32_t> small, large;
+      small.reserve(n);
+      large.reserve(n);
+      for (size_t i = 0; i < n; ++i) {
+        scaled[i] = probabilities_[i] * static_cast<double>(n);
+        (scaled[i] < 1 ? small : large).push_back(static_cast<uint32_t>(i));
+      }
+      columns_.resize(n);
+      while (!small.empty() && !large.empty()) {
+        const auto less = small.back();
+        const auto more = large.back();
+        small.pop_back();
+        large.pop_back();
+        columns_[less] = {static_cast<uint32_t>(scaled[less] * 0x1.0p32), more};
+        scaled[more] = (scaled[more] + scaled[less]) - 1;
+        (scaled[more] < 1 ? small : large).push_back(more);
+      }
+      // What is left is full, up to rounding.
+      for (auto i : large) columns_[i] = {0, i};
+      for (auto i : small) columns_[i] = {0, i};
+    }
+
+    std::vector<double> probabilities_;
+    std::vector<column> columns_;
+  };
+
+  discrete_distribution() = default;
+
+  template<typename InputIt>
+  discrete_distribution(InputIt first, InputIt last) : param_(first, last) {}
+
+  discrete_distribution(std::initializer_list<double> weights) : param_(weights) {}
+
+  template<typename UnaryOperation>
+  discrete_distribution(size_t count, double xmin, double xmax, UnaryOperation fw)
+      : param_(count, xmin, xmax, fw) {}
+
+  explicit discrete_distribution(const param_type& p) : param_(p) {}
+
+  void reset() {}
+
+  template<typename URBG>
+  result_type operator()(URBG& g) {
+    return (*this)(g, param_);
+  }
+
+  template<typename URBG>
+  result_type operator()(URBG& g, const param_type& p) {
+    const auto n = static_cast<uint32_t>(p.columns_.size());
+    uint64_t word = random_bits64(g);
+    uint64_t m = (word >> 32) * n;
+    if (static_cast<uint32_t>(m) < n) {
+      // Multiply-shift rejection, as in lemire::bounded.
+      const uint32_t threshold = -n % n;
+      while (static_cast<uint32_t>(m) < threshold) {
+        word = random_bits64(g);
+        m = (word >> 32) * n;
+      }
+    }
+    const auto& c = p.columns_[m >> 32];
+    return static_cast<result_type>(static_cast<uint32_t>(word) < c.threshold ? static_cast<uint32_t>(m >> 32)
+                                                                               : c.alias);
+  }
+
+  std::vector<double> probabilities() const { return param_.probabilities(); }
+  param_type param() const { return param_; }
+  void param(const param_type& p) { param_ = p; }
+  result_type min() const { return 0; }
+  result_type max() const { return static_cast<result_type>(param_.columns_.size() - 1); }
+
+  friend bool operator==(const discrete_distribution& lhs, const discrete_distribution& rhs) {
+    return lhs.param_ == rhs.param_;
+  }
+
+private:
+  param_type param_;
+};
+
+}
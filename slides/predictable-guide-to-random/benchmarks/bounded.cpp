@@ -0,0 +1,154 @@
+#include <benchmark/benchmark.h>
+
+#include "lemire.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// Integers in [1, range], as in roll_a_fair_die, from the library's
+// uniform_int_distribution and from multiply-shift; and shuffling and
+// sampling indices, where multiply-shift draws several at a time.
+
+template<typename Distribution, typename Engine>
+void Roll(benchmark::State& state) {
+  const auto range = static_cast<uint32_t>(state.range(0));
+  Engine e;
+  Distribution d{1, range};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(d(e));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    const auto value = d(e);
+    if (value < 1 || value > range)
+      throw std::logic_error("value out of range");
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Narrow types, whose arithmetic promotes to int: every value of [a, b]
+// must come up, each within 5% of its expected count.
+template<typename IntType>
+void CheckNarrow(IntType a, IntType b) {
+  const size_t kPerValue = 10'000;
+  const auto count = static_cast<size_t>(b - a) + 1;
+  std::mt19937 e;
+  lemire::uniform_int_distribution<IntType> d{a, b};
+  std::vector<size_t> frequencies(count);
+  for (size_t i = 0; i < count * kPerValue; ++i) {
+    const auto value = d(e);
+    if (value < a || value > b)
+      throw std::logic_error("value out of range");
+    ++frequencies[static_cast<size_t>(value - a)];
+  }
+  for (auto frequency : frequencies) {
+    if (frequency < kPerValue * 95 / 100 || frequency > kPerValue * 105 / 100)
+      throw std::logic_error("values are not uniform");
+  }
+}
+
+static void Check(benchmark::State& state) {
+  for (auto _ : state) {
+    CheckNarrow<short>(-5, 5);
+    CheckNarrow<short>(1, 6);
+    CheckNarrow<int8_t>(-5, 5);
+    CheckNarrow<int8_t>(std::numeric_limits<int8_t>::min(), std::numeric_limits<int8_t>::max());
+  }
+}
+
+void Ranges(benchmark::internal::Benchmark* b) {
+  // A die, a small and a large table, and a range where a quarter of the
+  // 32-bit words must be rejected.
+  b->ArgName("range")->Arg(6)->Arg(1000)->Arg(1 << 20)->Arg(int64_t{3} << 30);
+}
+
+namespace imp {
+
+// std::shuffle, or for a sample, Fisher-Yates with the library's
+// distribution; std::sample would keep the elements in their order.
+struct {
+template<typename It, typename Engine>
+void operator()(It first, It middle, It last, Engine& e) {
+  if (middle == last) {
+    std::shuffle(first, last, e);
+  } else {
+    using distribution = std::uniform_int_distribution<std::ptrdiff_t>;
+    distribution d;
+    for (; first != middle; ++first) {
+      std::iter_swap(first, first + d(e, distribution::param_type{0, last - first - 1}));
+    }
+  }
+}
+} std_shuffle;
+
+// One multiply-shift draw per position.
+struct {
+template<typename It, typename Engine>
+void operator()(It first, It middle, It last, Engine& e) {
+  for (auto remaining = static_cast<uint64_t>(last - first); first != middle && remaining > 1; ++first, --remaining) {
+    std::iter_swap(first, first + static_cast<std::ptrdiff_t>(lemire::bounded(e, remaining)));
+  }
+}
+} lemire_shuffle;
+
+struct {
+template<typename It, typename Engine>
+void operator()(It first, It middle, It last, Engine& e) {
+  lemire::partial_shuffle(first, middle, last, e);
+}
+} lemire_batched;
+
+}
+
+// Shuffles state.range(0) indices, or samples 1 in 16 of them when sample
+// is set.
+template<typename F>
+void Shuffle(benchmark::State& state, F f, bool sample) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const auto k = sample ? n / 16 : n;
+  std::vector<uint32_t> indices(n);
+  std::iota(indices.begin(), indices.end(), 0u);
+  std::mt19937_64 e;
+  for (auto _ : state) {
+    f(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(k), indices.end(), e);
+    benchmark::DoNotOptimize(indices.data());
+  }
+
+  std::vector<uint32_t> picked(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(k));
+  std::sort(picked.begin(), picked.end());
+  if (std::adjacent_find(picked.begin(), picked.end()) != picked.end() || (!picked.empty() && picked.back() >= n))
+    throw std::logic_error("indices are not a sample");
+  state.SetItemsProcessed(state.iterations() * k);
+}
+
+void Sizes(benchmark::internal::Benchmark* b) {
+  b->ArgName("n")->RangeMultiplier(64)->Range(64, 1 << 24);
+}
+
+#define BENCHMARK_ROLL(Engine)                                                                             \
+  BENCHMARK_TEMPLATE(Roll, std::uniform_int_distribution<uint32_t>, std::Engine)                           \
+      ->Name(#Engine "/std")                                                                               \
+      ->Apply(Ranges);                                                                                     \
+  BENCHMARK_TEMPLATE(Roll, lemire::uniform_int_distribution<uint32_t>, std::Engine)                        \
+      ->Name(#Engine "/lemire")                                                                            \
+      ->Apply(Ranges)
+
+#define BENCHMARK_SHUFFLE(Func)                                                                 \
+  BENCHMARK_CAPTURE(Shuffle, Func, imp::Func, false)->Name("shuffle/" #Func)->Apply(Sizes);     \
+  BENCHMARK_CAPTURE(Shuffle, Func, imp::Func, true)->Name("sample/" #Func)->Apply(Sizes)
+
+BENCHMARK(Check)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_ROLL(mt19937);
+BENCHMARK_ROLL(mt19937_64);
+BENCHMARK_ROLL(minstd_rand);
+
+BENCHMARK_SHUFFLE(std_shuffle);
+BENCHMARK_SHUFFLE(lemire_shuffle);
+BENCHMARK_SHUFFLE(lemire_batched);
+
+BENCHMARK_MAIN();
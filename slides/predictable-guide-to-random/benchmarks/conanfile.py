@@ -0,0 +1,22 @@
+from conan import ConanFile
+from conan.tools.cmake import CMake, CMakeToolchain, CMakeDeps
+
+class RandomBenchmarks(ConanFile):
+  name = 'random-benchmarks'
+  requires = [
+    'benchmark/1.6.1'
+  ]
+  settings = "os", "compiler", "arch", "build_type"
+
+  def generate(self):
+    deps = CMakeDeps(self)
+    deps.generate()
+
+    toolchain = CMakeToolchain(self)
+    toolchain.variables['CMAKE_CXX_STANDARD'] = '20'
+    toolchain.generate()
+
+  def build(self):
+    cmake = CMake(self)
+    cmake.configure()
+    cmake.build()
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "random_bits.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Uniform integers in a range by multiplying random bits by the range
+// instead of dividing them by it: the high half of the product is the
+// result, and a division is needed only in the rare case where the low half
+// falls close enough to the start for the result to be biased.
+// https://arxiv.org/abs/1805.10941
+//
+// Several ranges whose product fits in 64 bits can share one random word,
+// each taking the high half of its product and passing the low half on.
+// https://arxiv.org/abs/2408.06213
+namespace lemire {
+
+namespace detail {
+
+// The 128-bit product of a and b, high half first.
+inline std::pair<uint64_t, uint64_t> mul(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+  const auto product = static_cast<unsigned __int128>(a) * b;
+  return {static_cast<uint64_t>(product >> 64), static_cast<uint64_t>(product)};
+#elif defined(_MSC_VER) && defined(_M_X64)
+  uint64_t high;
+  const uint64_t low = _umul128(a, b, &high);
+  return {high, low};
+#else
+  const uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32, b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+  const uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+  const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  return {(hi_lo >> 32) + (cross >> 32) + hi_hi, (cross << 32) | (lo_lo & 0xFFFFFFFF)};
+#endif
+}
+
+}
+
+// A uniform integer in [0, range), range > 0.
+template<typename URBG>
+uint32_t bounded(URBG& g, uint32_t range) {
+  uint64_t m = uint64_t{random_bits32(g)} * range;
+  auto low = static_cast<uint32_t>(m);
+  if (low < range) {
+    const uint32_t threshold = -range % range;
+    while (low < threshold) {
+      m = uint64_t{random_bits32(g)} * range;
+      low = static_cast<uint32_t>(m);
+    }
+  }
+  return static_cast<uint32_t>(m >> 32);
+}
+
+template<typename URBG>
+uint64_t bounded(URBG& g, uint64_t range) {
+  auto [high, low] = detail::mul(random_bits64(g), range);
+  if (low < range) {
+    const uint64_t threshold = -range % range;
+    while (low < threshold) {
+      std::tie(high, low) = detail::mul(random_bits64(g), range);
+    }
+  }
+  return high;
+}
+
+// A uniform integer in [0, ranges[i]) for each i, from one random word
+// while it lasts. The product of ranges must fit in 64 bits.
+template<typename URBG>
+void bounded_batch(URBG& g, std::span<const uint64_t> ranges, std::span<uint64_t> out) {
+  uint64_t product = 1;
+  for (auto range : ranges) product *= range;
+  for (;;) {
+    uint64_t word = random_bits64(g);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      std::tie(out[i], word) = detail::mul(word, ranges[i]);
+    }
+    // As for a single range, with the last low half against the product.
+    if (word >= product || word >= -product % product) return;
+  }
+}
+
+// std::uniform_int_distribution's interface over bounded().
+template<typename IntType = int>
+class uniform_int_distribution {
+public:
+  using result_type = IntType;
+
+  explicit uniform_int_distribution(IntType a = 0, IntType b = std::numeric_limits<IntType>::max())
+      : a_(a), b_(b) {}
+
+  template<typename URBG>
+  result_type operator()(URBG& g) {
+    using unsigned_type = std::make_unsigned_t<IntType>;
+    using word = std::conditional_t<sizeof(IntType) <= 4, uint32_t, uint64_t>;
+    // Narrow types promote to int, so the difference wraps in unsigned_type
+    // before it widens to word.
+    const auto span = static_cast<word>(
+        static_cast<unsigned_type>(static_cast<unsigned_type>(b_) - static_cast<unsigned_type>(a_)));
+    if (span == std::numeric_limits<unsigned_type>::max()) {
+      // The full range of IntType.
+      return static_cast<IntType>(static_cast<unsigned_type>(a_) +
+                                  (sizeof(word) == 4 ? random_bits32(g) : random_bits64(g)));
+    }
+    return static_cast<IntType>(static_cast<unsigned_type>(a_) + bounded(g, static_cast<word>(span + 1)));
+  }
+
+  result_type a() const { return a_; }
+  result_type b() const { return b_; }
+  result_type min() const { return a_; }
+  result_type max() const { return b_; }
+
+private:
+  IntType a_;
+  IntType b_;
+};
+
+// Fisher-Yates on the first middle - first positions: each draws its
+// element from the rest of the range, so they end up a uniform sample of
+// it, in uniform order. Consecutive draws are batched while the product of
+// their ranges stays below 2^48, which keeps rejections rare.
+template<typename RandomIt, typename URBG>
+void partial_shuffle(RandomIt first, RandomIt middle, RandomIt last, URBG& g) {
+  constexpr size_t kMaxBatch = 6;
+  constexpr uint64_t kMaxProduct = uint64_t{1} << 48;
+  uint64_t ranges[kMaxBatch], picks[kMaxBatch];
+  for (auto remaining = static_cast<uint64_t>(last - first); first != middle && remaining > 1;) {
+    size_t count = 0;
+    uint64_t product = 1;
+    const auto left = static_cast<size_t>(middle - first);
+    do {
+      ranges[count] = remaining - count;
+      product *= ranges[count++];
+    } while (count < kMaxBatch && count < left && ranges[count - 1] > 2 &&
+             product <= kMaxProduct / (remaining - count));
+    bounded_batch(g, std::span<const uint64_t>{ranges, count}, std::span{picks, count});
+    for (size_t i = 0; i < count; ++i, ++first) {
+      std::iter_swap(first, first + static_cast<std::ptrdiff_t>(picks[i]));
+    }
+    remaining -= count;
+  }
+}
+
+template<typename RandomIt, typename URBG>
+void shuffle(RandomIt first, RandomIt last, URBG& g) {
+  partial_shuffle(first, last, last, g);
+}
+
+}
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include "philox.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+// Philox against the sequential engines: one output at a time, in bulk,
+// skipping ahead, and on every core with a key per thread.
+
+const size_t kBatch = 4096;
+
+template<typename Engine>
+void Serial(benchmark::State& state) {
+  Engine e;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(e());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void Fill(benchmark::State& state) {
+  philox4x32 e;
+  std::vector<uint32_t> words(kBatch);
+  for (auto _ : state) {
+    e.fill(std::span{words});
+    benchmark::DoNotOptimize(words.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+// The cost of skipping state.range(0) outputs, from a fresh engine.
+template<typename Engine>
+void Discard(benchmark::State& state) {
+  const auto n = static_cast<unsigned long long>(state.range(0));
+  for (auto _ : state) {
+    Engine e;
+    benchmark::DoNotOptimize(e);
+    e.discard(n);
+    benchmark::DoNotOptimize(e());
+  }
+}
+
+// Each thread fills its own buffer from its own key; with nothing shared,
+// the total rate should grow with the threads.
+static void Threads(benchmark::State& state) {
+  philox4x32 e(static_cast<uint64_t>(state.thread_index()));
+  std::vector<uint32_t> words(kBatch);
+  for (auto _ : state) {
+    e.fill(std::span{words});
+    benchmark::DoNotOptimize(words.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+BENCHMARK_TEMPLATE(Serial, philox4x32)->Name("philox4x32/serial");
+BENCHMARK_TEMPLATE(Serial, std::mt19937)->Name("mt19937/serial");
+BENCHMARK(Fill)->Name("philox4x32/fill");
+BENCHMARK_TEMPLATE(Discard, philox4x32)->Name("philox4x32/discard")->RangeMultiplier(64)->Range(1, 1 << 24);
+BENCHMARK_TEMPLATE(Discard, std::mt19937)->Name("mt19937/discard")->RangeMultiplier(64)->Range(1, 1 << 24);
+BENCHMARK_TEMPLATE(Discard, std::ranlux24)->Name("ranlux24/discard")->RangeMultiplier(64)->Range(1, 1 << 18);
+BENCHMARK(Threads)
+    ->Name("philox4x32/threads")
+    ->ThreadRange(1, static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)))
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
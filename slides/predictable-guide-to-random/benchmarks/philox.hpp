@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define PHILOX_AVX2 1
+#include <immintrin.h>
+#else
+#define PHILOX_AVX2 0
+#endif
+
+// Philox4x32-10, a counter-based engine: output block n is a keyed
+// bijection of the counter n, ten rounds of multiplications and xors, with
+// no state carried from one block to the next. Skipping ahead is setting
+// the counter, and threads with different keys get independent streams
+// with nothing shared.
+// Salmon et al., Parallel random numbers: as easy as 1, 2, 3,
+// https://www.thesalmons.org/john/random123/papers/random123sc11.pdf
+//
+// Each block gives 4 outputs, in order. fill() computes 8 blocks at a time
+// with AVX2 when the CPU has it.
+class philox4x32 {
+public:
+  using result_type = uint32_t;
+  using key_type = std::array<uint32_t, 2>;
+  using block_type = std::array<uint32_t, 4>;
+
+  static constexpr uint64_t default_seed = 20111115u;
+
+  explicit philox4x32(uint64_t key = default_seed) { seed(key); }
+
+  void seed(uint64_t key) {
+    key_ = {static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)};
+    position_ = 0;
+    cached_ = kNone;
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    const uint64_t counter = position_ / 4;
+    if (counter != cached_) {
+      cache_ = block(key_, {static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0, 0});
+      cached_ = counter;
+    }
+    return cache_[position_++ % 4];
+  }
+
+  void discard(unsigned long long n) { position_ += n; }
+
+  // The index of the next output; setting it moves to any output in O(1).
+  uint64_t position() const { return position_; }
+  void position(uint64_t p) { position_ = p; }
+
+  // The next out.size() outputs, as many calls would return.
+  void fill(std::span<uint32_t> out) {
+    for (; !out.empty() && position_ % 4 != 0; out = out.subspan(1)) out[0] = (*this)();
+    const size_t blocks = out.size() / 4;
+#if PHILOX_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) {
+      blocks_avx2(key_, position_ / 4, blocks, out.data());
+    } else {
+      blocks_scalar(key_, position_ / 4, blocks, out.data());
+    }
+#else
+    blocks_scalar(key_, position_ / 4, blocks, out.data());
+#endif
+    position_ += 4 * blocks;
+    for (out = out.subspan(4 * blocks); !out.empty(); out = out.subspan(1)) out[0] = (*this)();
+  }
+
+  // Output block counter under key.
+  static block_type block(key_type key, block_type counter) {
+    for (int round = 0; round < 10; ++round) {
+      const uint64_t p0 = uint64_t{kM0} * counter[0];
+      const uint64_t p1 = uint64_t{kM1} * counter[2];
+      counter = {static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(p1),
+                 static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(p0)};
+      key[0] += kW0;
+      key[1] += kW1;
+    }
+    return counter;
+  }
+
+  friend bool operator==(const philox4x32& lhs, const philox4x32& rhs) {
+    return lhs.key_ == rhs.key_ && lhs.position_ == rhs.position_;
+  }
+
+private:
+  static constexpr uint32_t kM0 = 0xD2511F53;
+  static constexpr uint32_t kM1 = 0xCD9E8D57;
+  static constexpr uint32_t kW0 = 0x9E3779B9;
+  static constexpr uint32_t kW1 = 0xBB67AE85;
+  static constexpr uint64_t kNone = std::numeric_limits<uint64_t>::max();
+
+  // Blocks first, first + 1, ... of a 64-bit counter, 4 outputs each.
+  static void blocks_scalar(key_type key, uint64_t first, size_t count, uint32_t* out) {
+    for (size_t i = 0; i < count; ++i, out += 4) {
+      const uint64_t counter = first + i;
+      const auto b = block(key, {static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0, 0});
+      for (size_t w = 0; w < 4; ++w) out[w] = b[w];
+    }
+  }
+
+#if PHILOX_AVX2
+  // The low and high halves of the 32-bit products of each lane of a and m.
+  __attribute__((target("avx2"))) static void mul(__m256i a, __m256i m, __m256i& lo, __m256i& hi) {
+    const auto even = _mm256_mul_epu32(a, m);
+    const auto odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+  }
+
+  // 8 blocks at a time, lane j holding word w of block j in vector w, then
+  // transposed so that the blocks are stored one after the other.
+  __attribute__((target("avx2"))) static void blocks_avx2(key_type key, uint64_t first, size_t count,
+                                                          uint32_t* out) {
+    const auto m0 = _mm256_set1_epi32(static_cast<int>(kM0));
+    const auto m1 = _mm256_set1_epi32(static_cast<int>(kM1));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8, out += 32) {
+      alignas(32) uint32_t lows[8], highs[8];
+      for (size_t j = 0; j < 8; ++j) {
+        lows[j] = static_cast<uint32_t>(first + i + j);
+        highs[j] = static_cast<uint32_t>((first + i + j) >> 32);
+      }
+      auto c0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(lows));
+      auto c1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(highs));
+      auto c2 = _mm256_setzero_si256();
+      auto c3 = _mm256_setzero_si256();
+      auto k = key;
+      for (int round = 0; round < 10; ++round) {
+        __m256i lo0, hi0, lo1, hi1;
+        mul(c0, m0, lo0, hi0);
+        mul(c2, m1, lo1, hi1);
+        c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(static_cast<int>(k[0])));
+        c1 = lo1;
+        c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(static_cast<int>(k[1])));
+        c3 = lo0;
+        k[0] += kW0;
+        k[1] += kW1;
+      }
+      const auto t0 = _mm256_unpacklo_epi32(c0, c1);
+      const auto t1 = _mm256_unpackhi_epi32(c0, c1);
+      const auto t2 = _mm256_unpacklo_epi32(c2, c3);
+      const auto t3 = _mm256_unpackhi_epi32(c2, c3);
+      const auto b04 = _mm256_unpacklo_epi64(t0, t2);
+      const auto b15 = _mm256_unpackhi_epi64(t0, t2);
+      const auto b26 = _mm256_unpacklo_epi64(t1, t3);
+      const auto b37 = _mm256_unpackhi_epi64(t1, t3);
+      auto* p = reinterpret_cast<__m256i*>(out);
+      _mm256_storeu_si256(p, _mm256_permute2x128_si256(b04, b15, 0x20));
+      _mm256_storeu_si256(p + 1, _mm256_permute2x128_si256(b26, b37, 0x20));
+      _mm256_storeu_si256(p + 2, _mm256_permute2x128_si256(b04, b15, 0x31));
+      _mm256_storeu_si256(p + 3, _mm256_permute2x128_si256(b26, b37, 0x31));
+    }
+    blocks_scalar(key, first + i, count - i, out);
+  }
+#endif
+
+  key_type key_;
+  uint64_t position_ = 0;
+  block_type cache_{};
+  uint64_t cached_ = kNone;
+};
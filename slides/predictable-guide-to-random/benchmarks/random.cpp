@@ -0,0 +1,172 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Every library engine with every library distribution, as in the slides'
+// distribute<Distribution, Engine>. The time is per sample; bits/ns is the
+// engine output consumed, reported as a rate of G/s, which is what a
+// distribution costs beyond its own arithmetic.
+
+namespace engine {
+
+using minstd_rand0 = std::minstd_rand0;
+using minstd_rand = std::minstd_rand;
+using mt19937 = std::mt19937;
+using mt19937_64 = std::mt19937_64;
+using ranlux24_base = std::ranlux24_base;
+using ranlux48_base = std::ranlux48_base;
+using ranlux24 = std::ranlux24;
+using ranlux48 = std::ranlux48;
+using knuth_b = std::knuth_b;
+using independent_bits = std::independent_bits_engine<std::mt19937, 64, uint64_t>;
+using default_random_engine = std::default_random_engine;
+
+}
+
+// The distributions are default constructed, except where the default is
+// degenerate: a single trial, or a single weight to sample from.
+namespace dist {
+
+// 16 intervals, and a weight for each of their 17 bounds.
+const std::vector<double>& bounds() {
+  static const auto bounds = [] {
+    std::vector<double> bounds(17);
+    std::iota(bounds.begin(), bounds.end(), 0.0);
+    return bounds;
+  }();
+  return bounds;
+}
+
+const std::vector<double>& weights() {
+  static const auto weights = [] {
+    std::vector<double> weights(17);
+    std::iota(weights.begin(), weights.end(), 1.0);
+    return weights;
+  }();
+  return weights;
+}
+
+// The engine itself, as a distribution of its own range.
+struct raw {
+  template<typename Engine>
+  auto operator()(Engine& e) { return e(); }
+};
+
+using uniform_int = std::uniform_int_distribution<>;
+using uniform_real = std::uniform_real_distribution<>;
+using bernoulli = std::bernoulli_distribution;
+struct binomial : std::binomial_distribution<> {
+  binomial() : binomial_distribution(16, 0.5) {}
+};
+using negative_binomial = std::negative_binomial_distribution<>;
+using geometric = std::geometric_distribution<>;
+using poisson = std::poisson_distribution<>;
+using exponential = std::exponential_distribution<>;
+using gamma = std::gamma_distribution<>;
+using weibull = std::weibull_distribution<>;
+using extreme_value = std::extreme_value_distribution<>;
+using normal = std::normal_distribution<>;
+using lognormal = std::lognormal_distribution<>;
+using chi_squared = std::chi_squared_distribution<>;
+using cauchy = std::cauchy_distribution<>;
+using fisher_f = std::fisher_f_distribution<>;
+using student_t = std::student_t_distribution<>;
+struct discrete : std::discrete_distribution<> {
+  discrete() : discrete_distribution(weights().begin(), weights().end()) {}
+};
+struct piecewise_constant : std::piecewise_constant_distribution<> {
+  piecewise_constant()
+      : piecewise_constant_distribution(bounds().begin(), bounds().end(), weights().begin()) {}
+};
+struct piecewise_linear : std::piecewise_linear_distribution<> {
+  piecewise_linear()
+      : piecewise_linear_distribution(bounds().begin(), bounds().end(), weights().begin()) {}
+};
+
+}
+
+// Counts the calls to an engine.
+template<typename Engine>
+struct counting_engine {
+  using result_type = typename Engine::result_type;
+
+  static constexpr result_type min() { return Engine::min(); }
+  static constexpr result_type max() { return Engine::max(); }
+
+  result_type operator()() {
+    ++calls;
+    return engine();
+  }
+
+  Engine engine;
+  uint64_t calls = 0;
+};
+
+template<typename Engine>
+double EngineBits() {
+  return std::log2(static_cast<double>(Engine::max() - Engine::min()) + 1);
+}
+
+template<typename Distribution, typename Engine>
+void Distribute(benchmark::State& state) {
+  Engine e;
+  Distribution d;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(d(e));
+  }
+
+  // The engine calls per sample, counted apart so as not to slow the loop.
+  const int kSamples = 100'000;
+  counting_engine<Engine> counter;
+  Distribution counted;
+  for (int i = 0; i < kSamples; ++i) {
+    benchmark::DoNotOptimize(counted(counter));
+  }
+  const double bits = EngineBits<Engine>() * static_cast<double>(counter.calls) / kSamples;
+  state.counters["bits"] = benchmark::Counter(bits * static_cast<double>(state.iterations()),
+                                              benchmark::Counter::kIsRate);
+}
+
+#define BENCHMARK_DISTRIBUTE(Engine, Dist) \
+  BENCHMARK_TEMPLATE(Distribute, dist::Dist, engine::Engine)->Name(#Engine "/" #Dist)
+
+#define BENCHMARK_ENGINE(Engine)                          \
+  BENCHMARK_DISTRIBUTE(Engine, raw);                      \
+  BENCHMARK_DISTRIBUTE(Engine, uniform_int);              \
+  BENCHMARK_DISTRIBUTE(Engine, uniform_real);             \
+  BENCHMARK_DISTRIBUTE(Engine, bernoulli);                \
+  BENCHMARK_DISTRIBUTE(Engine, binomial);                 \
+  BENCHMARK_DISTRIBUTE(Engine, negative_binomial);        \
+  BENCHMARK_DISTRIBUTE(Engine, geometric);                \
+  BENCHMARK_DISTRIBUTE(Engine, poisson);                  \
+  BENCHMARK_DISTRIBUTE(Engine, exponential);              \
+  BENCHMARK_DISTRIBUTE(Engine, gamma);                    \
+  BENCHMARK_DISTRIBUTE(Engine, weibull);                  \
+  BENCHMARK_DISTRIBUTE(Engine, extreme_value);            \
+  BENCHMARK_DISTRIBUTE(Engine, normal);                   \
+  BENCHMARK_DISTRIBUTE(Engine, lognormal);                \
+  BENCHMARK_DISTRIBUTE(Engine, chi_squared);              \
+  BENCHMARK_DISTRIBUTE(Engine, cauchy);                   \
+  BENCHMARK_DISTRIBUTE(Engine, fisher_f);                 \
+  BENCHMARK_DISTRIBUTE(Engine, student_t);                \
+  BENCHMARK_DISTRIBUTE(Engine, discrete);                 \
+  BENCHMARK_DISTRIBUTE(Engine, piecewise_constant);       \
+  BENCHMARK_DISTRIBUTE(Engine, piecewise_linear)
+
+BENCHMARK_ENGINE(minstd_rand0);
+BENCHMARK_ENGINE(minstd_rand);
+BENCHMARK_ENGINE(mt19937);
+BENCHMARK_ENGINE(mt19937_64);
+BENCHMARK_ENGINE(ranlux24_base);
+BENCHMARK_ENGINE(ranlux48_base);
+BENCHMARK_ENGINE(ranlux24);
+BENCHMARK_ENGINE(ranlux48);
+BENCHMARK_ENGINE(knuth_b);
+BENCHMARK_ENGINE(independent_bits);
+BENCHMARK_ENGINE(default_random_engine);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+// Uniform 32 or 64 bits from any engine. Engines with a full 32 or 64-bit
+// range are used directly; others, like minstd_rand, go through the
+// standard distribution.
+
+namespace detail {
+
+template<typename URBG, unsigned Bits>
+constexpr bool full_range =
+    URBG::min() == 0 && URBG::max() == std::numeric_limits<std::conditional_t<Bits == 32, uint32_t, uint64_t>>::max();
+
+}
+
+template<typename URBG>
+uint32_t random_bits32(URBG& g) {
+  if constexpr (detail::full_range<URBG, 32>) {
+    return static_cast<uint32_t>(g());
+  } else if constexpr (detail::full_range<URBG, 64>) {
+    return static_cast<uint32_t>(g() >> 32);
+  } else {
+    return std::uniform_int_distribution<uint32_t>{}(g);
+  }
+}
+
+template<typename URBG>
+uint64_t random_bits64(URBG& g) {
+  if constexpr (detail::full_range<URBG, 64>) {
+    return g();
+  } else if constexpr (detail::full_range<URBG, 32>) {
+    const uint64_t high = g();
+    return (high << 32) | static_cast<uint32_t>(g());
+  } else {
+    return std::uniform_int_distribution<uint64_t>{}(g);
+  }
+}
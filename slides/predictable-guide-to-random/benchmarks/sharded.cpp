@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include "sharded.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+// roll_a_fair_die called from 1..N threads at once, with its static engine
+// behind a mutex and sharded per thread.
+
+namespace imp {
+
+struct {
+int operator()() {
+  static std::mutex m;
+  static std::default_random_engine e{0x12345678};
+  std::uniform_int_distribution<int> d{1, 6};
+  std::lock_guard lock{m};
+  return d(e);
+}
+} mutex;
+
+struct {
+int operator()() {
+  static sharded::engine<> e{0x12345678};
+  std::uniform_int_distribution<int> d{1, 6};
+  return d(e);
+}
+} sharded;
+
+}
+
+const int kRolls = 1024;
+
+template<typename F>
+void Roll(benchmark::State& state, F f) {
+  // Numbered by benchmark thread; setting the shard restarts its stream, so
+  // each draws the same values every run.
+  sharded::set_this_thread_shard(static_cast<size_t>(state.thread_index()));
+  for (auto _ : state) {
+    int sum = 0;
+    for (int i = 0; i < kRolls; ++i) sum += f();
+    if (sum < kRolls || sum > 6 * kRolls)
+      throw std::logic_error("invalid rolls");
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kRolls);
+}
+
+#define BENCHMARK_ROLL(Func)                                                                \
+  BENCHMARK_CAPTURE(Roll, Func, imp::Func)                                                  \
+      ->Name(#Func)                                                                         \
+      ->ThreadRange(1, static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u))) \
+      ->UseRealTime()
+
+BENCHMARK_ROLL(mutex);
+BENCHMARK_ROLL(sharded);
+
+BENCHMARK_MAIN();
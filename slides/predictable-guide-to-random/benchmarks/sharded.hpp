@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// An engine that can be shared between threads, as the function-local
+// static engine of roll_a_fair_die is, without a lock: each thread draws
+// from its own engine, seeded on first use by a seed_seq of the master seed
+// and the thread's shard number.
+//
+//   int roll_a_fair_die() {
+//     static sharded::engine<> e{0x12345678};
+//     std::uniform_int_distribution<int> d{1, 6};
+//     return d(e);
+//   }
+//
+// A thread's shard is the one it set with set_this_thread_shard, or else
+// the next free number when it first asks. The numbers given out count
+// from the top bit, which set ones may not use, so no two threads share a
+// stream. Setting a shard, even the one already set, restarts the thread's
+// engines from the shard's first state: threads that set theirs, like the
+// workers of a pool numbered 0..N-1, draw the same values on every run.
+namespace sharded {
+
+namespace detail {
+
+inline constexpr size_t kAutomatic = size_t{1} << (std::numeric_limits<size_t>::digits - 1);
+
+inline std::atomic<size_t> next_shard{kAutomatic};
+inline thread_local std::optional<size_t> shard;
+// Counts the shards the thread set; engines seeded at an older count are
+// seeded again.
+inline thread_local uint64_t generation = 0;
+inline std::atomic<uint64_t> next_id{0};
+
+}
+
+inline void set_this_thread_shard(size_t shard) {
+  if (shard >= detail::kAutomatic)
+    throw std::invalid_argument("shard is in the automatic range");
+  detail::shard = shard;
+  ++detail::generation;
+}
+
+inline size_t this_thread_shard() {
+  if (!detail::shard) detail::shard = detail::next_shard++;
+  return *detail::shard;
+}
+
+template<typename Engine = std::default_random_engine>
+class engine {
+public:
+  using result_type = typename Engine::result_type;
+
+  explicit engine(uint64_t master_seed) : master_seed_(master_seed), id_(detail::next_id++) {}
+
+  static constexpr result_type min() { return Engine::min(); }
+  static constexpr result_type max() { return Engine::max(); }
+
+  result_type operator()() { return local()(); }
+
+  // The calling thread's engine.
+  Engine& local() {
+    // Each thread keeps the engines it has drawn from, the last one first.
+    thread_local std::vector<std::unique_ptr<slot>> slots;
+    thread_local slot* last = nullptr;
+    if (last && last->id == id_ && last->generation == detail::generation) return last->engine;
+    for (auto& s : slots) {
+      if (s->id == id_) {
+        if (s->generation != detail::generation) {
+          s->engine = for_shard(this_thread_shard());
+          s->generation = detail::generation;
+        }
+        last = s.get();
+        return last->engine;
+      }
+    }
+    slots.push_back(std::make_unique<slot>(slot{id_, detail::generation, for_shard(this_thread_shard())}));
+    last = slots.back().get();
+    return last->engine;
+  }
+
+  // A new engine in the state shard starts from.
+  Engine for_shard(size_t shard) const {
+    std::seed_seq seq{static_cast<uint32_t>(master_seed_), static_cast<uint32_t>(master_seed_ >> 32),
+                      static_cast<uint32_t>(shard), static_cast<uint32_t>(uint64_t{shard} >> 32)};
+    return Engine(seq);
+  }
+
+private:
+  struct slot {
+    uint64_t id;
+    uint64_t generation;
+    Engine engine;
+  };
+
+  uint64_t master_seed_;
+  // Engines are told apart by a number rather than their address, which a
+  // later one may reuse.
+  uint64_t id_;
+};
+
+}
@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+
+#include "ziggurat.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Normal and exponential variates from the library distributions and from
+// the Ziggurat ones, one at a time and in batches. Before timing, the
+// Ziggurat moments are checked against the library's, and the batches
+// against one value at a time.
+
+const size_t kBatch = 4096;
+
+struct Moments {
+  double mean = 0;
+  double variance = 0;
+  double skewness = 0;
+  double kurtosis = 0;
+
+  explicit Moments(const std::vector<double>& values) {
+    for (double x : values) mean += x;
+    mean /= static_cast<double>(values.size());
+    double m2 = 0, m3 = 0, m4 = 0;
+    for (double x : values) {
+      const double d = x - mean;
+      m2 += d * d;
+      m3 += d * d * d;
+      m4 += d * d * d * d;
+    }
+    m2 /= static_cast<double>(values.size());
+    m3 /= static_cast<double>(values.size());
+    m4 /= static_cast<double>(values.size());
+    variance = m2;
+    skewness = m3 / std::pow(m2, 1.5);
+    kurtosis = m4 / (m2 * m2);
+  }
+};
+
+// A million variates of each with the same parameters; the tolerances are
+// several standard errors of the moments for the exponential, the wider of
+// the two.
+template<typename Distribution, typename Standard, typename... Params>
+void CheckMoments(Params... params) {
+  const size_t kSamples = 1'000'000;
+  std::mt19937_64 e;
+  Distribution d{params...};
+  Standard s{params...};
+  std::vector<double> values(kSamples), expected(kSamples);
+  for (auto& value : values) value = d(e);
+  for (auto& value : expected) value = s(e);
+
+  const Moments actual{values}, reference{expected};
+  const double sigma = std::sqrt(reference.variance);
+  auto check = [](const char* name, double value, double reference, double tolerance) {
+    if (std::abs(value - reference) > tolerance)
+      throw std::logic_error(std::string{name} + " differs from the standard distribution");
+  };
+  check("mean", actual.mean, reference.mean, 0.01 * sigma);
+  check("variance", actual.variance, reference.variance, 0.02 * reference.variance);
+  check("skewness", actual.skewness, reference.skewness, 0.1);
+  check("kurtosis", actual.kurtosis, reference.kurtosis, 1.0);
+}
+
+// fill from one engine against as many calls from a copy of it: the values
+// and the engine states after must be the same. The size is not a multiple
+// of the batch.
+template<typename Distribution, typename Engine, typename... Params>
+void CheckFill(Params... params) {
+  const size_t kSamples = 100'003;
+  Engine e, copy;
+  Distribution d{params...};
+  std::vector<double> values(kSamples), expected(kSamples);
+  d.fill(e, std::span{values});
+  for (auto& value : expected) value = d(copy);
+  if (values != expected || e != copy)
+    throw std::logic_error("fill differs from repeated calls");
+}
+
+template<typename Distribution, typename Engine>
+void Sample(benchmark::State& state) {
+  Engine e;
+  Distribution d;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(d(e));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Distribution, typename Engine>
+void Fill(benchmark::State& state) {
+  Engine e;
+  Distribution d;
+  std::vector<double> values(kBatch);
+  for (auto _ : state) {
+    d.fill(e, std::span{values});
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+static void Check(benchmark::State& state) {
+  for (auto _ : state) {
+    CheckMoments<ziggurat::normal_distribution<>, std::normal_distribution<>>(5.0, 2.0);
+    CheckMoments<ziggurat::exponential_distribution<>, std::exponential_distribution<>>(1.5);
+    CheckFill<ziggurat::normal_distribution<>, std::mt19937>(5.0, 2.0);
+    CheckFill<ziggurat::normal_distribution<>, std::mt19937_64>(5.0, 2.0);
+    CheckFill<ziggurat::exponential_distribution<>, std::mt19937>(1.5);
+    CheckFill<ziggurat::exponential_distribution<>, std::mt19937_64>(1.5);
+  }
+}
+
+#define BENCHMARK_ZIGGURAT(Dist, Engine)                                                               \
+  BENCHMARK_TEMPLATE(Sample, std::Dist##_distribution<>, std::Engine)->Name(#Dist "/" #Engine "/std"); \
+  BENCHMARK_TEMPLATE(Sample, ziggurat::Dist##_distribution<>, std::Engine)                             \
+      ->Name(#Dist "/" #Engine "/ziggurat");                                                           \
+  BENCHMARK_TEMPLATE(Fill, ziggurat::Dist##_distribution<>, std::Engine)                               \
+      ->Name(#Dist "/" #Engine "/ziggurat_fill")
+
+BENCHMARK(Check)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_ZIGGURAT(normal, mt19937);
+BENCHMARK_ZIGGURAT(normal, mt19937_64);
+BENCHMARK_ZIGGURAT(exponential, mt19937);
+BENCHMARK_ZIGGURAT(exponential, mt19937_64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,315 @@
+#pragma once
+
+#include "random_bits.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+// Normal and exponential variates by the Ziggurat method: the density is
+// covered by 256 layers of equal area, so that a random layer and a random
+// point across its width lands under the density most of the time, with no
+// logarithm or square root. Only points in a layer's edge past the next one,
+// and the tail beyond the base layer, need the density computed.
+// Marsaglia & Tsang, https://www.jstatsoft.org/article/view/v005i08
+//
+// The distributions have the interface of their standard counterparts,
+// param_type included. Their fill() draws a batch at once: a branch-free
+// pass computes every value from a 64-bit word and marks those inside their
+// layer, then the few others take the slow path one at a time. The slow
+// path takes the words it needs from the batch before the engine, so fill
+// gives the same values as repeated calls.
+namespace ziggurat {
+
+namespace detail {
+
+constexpr size_t kLayers = 256;
+
+// Layer i spans [0, x[i]) and the next layer up ends at x[i + 1]; layer 0
+// is the base, a rectangle up to x[1] = r plus the tail past r, whose area
+// v makes it as wide as x[0].
+struct table {
+  std::array<double, kLayers + 1> x;
+  std::array<double, kLayers + 1> f;
+  // x[i + 1] / x[i]: a point below it in layer i is under the density.
+  std::array<double, kLayers> ratio;
+
+  template<typename F, typename Inverse>
+  table(double r, double v, F density, Inverse inverse) {
+    x[0] = v / density(r);
+    x[1] = r;
+    for (size_t i = 1; i < kLayers - 1; ++i) {
+      x[i + 1] = inverse(density(x[i]) + v / x[i]);
+    }
+    x[kLayers] = 0;
+    for (size_t i = 0; i <= kLayers; ++i) f[i] = density(x[i]);
+    for (size_t i = 0; i < kLayers; ++i) ratio[i] = x[i + 1] / x[i];
+  }
+};
+
+inline double normal_density(double x) { return std::exp(-0.5 * x * x); }
+inline double exponential_density(double x) { return std::exp(-x); }
+
+inline const table& normal_table() {
+  static const table t{3.6541528853610088, 0.00492867323399, normal_density,
+                       [](double y) { return std::sqrt(-2 * std::log(y)); }};
+  return t;
+}
+
+inline const table& exponential_table() {
+  static const table t{7.69711747013104972, 0.0039496598225815571993, exponential_density,
+                       [](double y) { return -std::log(y); }};
+  return t;
+}
+
+// The 53 high bits as a double in [0, 1).
+inline double unit(uint64_t bits) { return static_cast<double>(bits >> 11) * 0x1.0p-53; }
+
+// (0, 1], safe for a logarithm.
+template<typename URBG>
+double open_unit(URBG& g) {
+  return 1 - unit(random_bits64(g));
+}
+
+// The fast path on word: the low 8 bits pick a layer, bit 8 is the sign
+// for the normal and the high 53 bits the position across the layer.
+// Returns whether the point is inside the layer below.
+inline bool fast(const table& t, uint64_t word, bool symmetric, double& out) {
+  const size_t i = word & 0xFF;
+  const double u = unit(word);
+  double x = u * t.x[i];
+  if (symmetric && (word & 0x100)) x = -x;
+  out = x;
+  return u < t.ratio[i];
+}
+
+// The slow path, for a word whose point fell outside the layer below: the
+// tail for the base layer, or else whether the point in the layer's edge is
+// under the density. Returns whether x is a variate; if not, the draw is
+// rejected and starts over.
+template<typename URBG>
+bool normal_edge(URBG& g, uint64_t word, double& x) {
+  const auto& t = normal_table();
+  const size_t i = word & 0xFF;
+  if (i == 0) {
+    // The tail past r, by Marsaglia's method.
+    const double r = t.x[1];
+    double tail, y;
+    do {
+      tail = -std::log(open_unit(g)) / r;
+      y = -std::log(open_unit(g));
+    } while (2 * y < tail * tail);
+    x = x < 0 ? -(r + tail) : r + tail;
+    return true;
+  }
+  return t.f[i] + unit(random_bits64(g)) * (t.f[i + 1] - t.f[i]) < normal_density(x);
+}
+
+template<typename URBG>
+double standard_normal(URBG& g) {
+  for (;;) {
+    const uint64_t word = random_bits64(g);
+    double x;
+    if (fast(normal_table(), word, true, x) || normal_edge(g, word, x)) return x;
+  }
+}
+
+template<typename URBG>
+double standard_exponential(URBG& g);
+
+template<typename URBG>
+bool exponential_edge(URBG& g, uint64_t word, double& x) {
+  const auto& t = exponential_table();
+  const size_t i = word & 0xFF;
+  if (i == 0) {
+    // The tail past r is the distribution itself, shifted.
+    x = t.x[1] + standard_exponential(g);
+    return true;
+  }
+  return t.f[i] + unit(random_bits64(g)) * (t.f[i + 1] - t.f[i]) < exponential_density(x);
+}
+
+template<typename URBG>
+double standard_exponential(URBG& g) {
+  for (;;) {
+    const uint64_t word = random_bits64(g);
+    double x;
+    if (fast(exponential_table(), word, false, x) || exponential_edge(g, word, x)) return x;
+  }
+}
+
+// Words already drawn for a batch, then the engine's, so that a slow path
+// in the middle of a batch draws the words it would have outside one.
+template<typename URBG>
+class buffered {
+public:
+  using result_type = uint64_t;
+
+  buffered(URBG& g, const uint64_t* first, const uint64_t* last) : g_(g), next_(first), last_(last) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() { return next_ != last_ ? *next_++ : random_bits64(g_); }
+
+  const uint64_t* next() const { return next_; }
+
+private:
+  URBG& g_;
+  const uint64_t* next_;
+  const uint64_t* last_;
+};
+
+// Fills out with standard variates of table t, then scales them. Words
+// outside their layer go through edge, and retry when it rejects them; the
+// words they draw are not variates of their own.
+template<typename URBG, typename RealType, typename Edge, typename Retry, typename Scale>
+void fill(URBG& g, std::span<RealType> out, const table& t, bool symmetric, Edge edge, Retry retry,
+          Scale scale) {
+  constexpr size_t kBatch = 256;
+  uint64_t words[kBatch];
+  double values[kBatch];
+  bool inside[kBatch];
+  while (!out.empty()) {
+    // Every value takes at least one word, so the batch never draws past
+    // what repeated calls would.
+    const size_t count = std::min(kBatch, out.size());
+    for (size_t i = 0; i < count; ++i) words[i] = random_bits64(g);
+    for (size_t i = 0; i < count; ++i) inside[i] = fast(t, words[i], symmetric, values[i]);
+    size_t filled = 0;
+    for (size_t i = 0; i < count; ++filled) {
+      if (inside[i]) {
+        out[filled] = static_cast<RealType>(scale(values[i++]));
+        continue;
+      }
+      buffered<URBG> rest{g, words + i + 1, words + count};
+      double x = values[i];
+      if (!edge(rest, words[i], x)) x = retry(rest);
+      out[filled] = static_cast<RealType>(scale(x));
+      i = static_cast<size_t>(rest.next() - words);
+    }
+    out = out.subspan(filled);
+  }
+}
+}
+
+template<typename RealType = double>
+class normal_distribution {
+public:
+  using result_type = RealType;
+
+  class param_type {
+  public:
+    using distribution_type = normal_distribution;
+
+    explicit param_type(RealType mean = 0, RealType stddev = 1) : mean_(mean), stddev_(stddev) {}
+
+    RealType mean() const { return mean_; }
+    RealType stddev() const { return stddev_; }
+
+    friend bool operator==(const param_type&, const param_type&) = default;
+
+  private:
+    RealType mean_;
+    RealType stddev_;
+  };
+
+  explicit normal_distribution(RealType mean = 0, RealType stddev = 1) : param_(mean, stddev) {}
+  explicit normal_distribution(const param_type& p) : param_(p) {}
+
+  void reset() {}
+
+  template<typename URBG>
+  result_type operator()(URBG& g) {
+    return (*this)(g, param_);
+  }
+
+  template<typename URBG>
+  result_type operator()(URBG& g, const param_type& p) {
+    return static_cast<RealType>(p.mean() + p.stddev() * detail::standard_normal(g));
+  }
+
+  template<typename URBG>
+  void fill(URBG& g, std::span<RealType> out) {
+    const auto p = param_;
+    detail::fill(
+        g, out, detail::normal_table(), true,
+        [](auto& source, uint64_t word, double& x) { return detail::normal_edge(source, word, x); },
+        [](auto& source) { return detail::standard_normal(source); },
+        [p](double z) { return p.mean() + p.stddev() * z; });
+  }
+
+  RealType mean() const { return param_.mean(); }
+  RealType stddev() const { return param_.stddev(); }
+  param_type param() const { return param_; }
+  void param(const param_type& p) { param_ = p; }
+  result_type min() const { return std::numeric_limits<RealType>::lowest(); }
+  result_type max() const { return std::numeric_limits<RealType>::max(); }
+
+  friend bool operator==(const normal_distribution&, const normal_distribution&) = default;
+
+private:
+  param_type param_;
+};
+
+template<typename RealType = double>
+class exponential_distribution {
+public:
+  using result_type = RealType;
+
+  class param_type {
+  public:
+    using distribution_type = exponential_distribution;
+
+    explicit param_type(RealType lambda = 1) : lambda_(lambda) {}
+
+    RealType lambda() const { return lambda_; }
+
+    friend bool operator==(const param_type&, const param_type&) = default;
+
+  private:
+    RealType lambda_;
+  };
+
+  explicit exponential_distribution(RealType lambda = 1) : param_(lambda) {}
+  explicit exponential_distribution(const param_type& p) : param_(p) {}
+
+  void reset() {}
+
+  template<typename URBG>
+  result_type operator()(URBG& g) {
+    return (*this)(g, param_);
+  }
+
+  template<typename URBG>
+  result_type operator()(URBG& g, const param_type& p) {
+    return static_cast<RealType>(detail::standard_exponential(g) / p.lambda());
+  }
+
+  template<typename URBG>
+  void fill(URBG& g, std::span<RealType> out) {
+    const auto p = param_;
+    detail::fill(
+        g, out, detail::exponential_table(), false,
+        [](auto& source, uint64_t word, double& x) { return detail::exponential_edge(source, word, x); },
+        [](auto& source) { return detail::standard_exponential(source); },
+        [p](double z) { return z / p.lambda(); });
+  }
+
+  RealType lambda() const { return param_.lambda(); }
+  param_type param() const { return param_; }
+  void param(const param_type& p) { param_ = p; }
+  result_type min() const { return 0; }
+  result_type max() const { return std::numeric_limits<RealType>::max(); }
+
+  friend bool operator==(const exponential_distribution&, const exponential_distribution&) = default;
+
+private:
+  param_type param_;
+};
+
+}